@@ -0,0 +1,95 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+// Global operator new / delete replacements feeding AllocationTracker. Linked into the executables only
+// (CMake option SW_ENABLE_ALLOCATION_HOOKS), sw_core itself never replaces the allocator of its host.
+// Every block carries its size and the distance to the malloc'ed start in the two words before it.
+
+#include <Core/Engine/AllocationTracker.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	using sw::core::AllocationTracker;
+
+	constexpr size_t HEADER_BYTES = std::max<size_t>(2 * sizeof(size_t), alignof(std::max_align_t));
+
+	void* allocate(size_t size, size_t alignment) noexcept
+	{
+		const size_t header = std::max(HEADER_BYTES, alignment);
+		char* raw = nullptr;
+		if (alignment <= alignof(std::max_align_t))
+		{
+			raw = static_cast<char*>(std::malloc(size + header));
+		}
+		else
+		{
+			// aligned_alloc wants a multiple of the alignment
+			raw = static_cast<char*>(std::aligned_alloc(alignment, (size + header + alignment - 1) / alignment * alignment));
+		}
+		if (!raw)
+		{
+			return nullptr;
+		}
+		char* block = raw + header;
+		reinterpret_cast<size_t*>(block)[-1] = size;
+		reinterpret_cast<size_t*>(block)[-2] = header;
+		AllocationTracker::onAllocate(size);
+		return block;
+	}
+
+	void release(void* pointer) noexcept
+	{
+		if (!pointer)
+		{
+			return;
+		}
+		char* block = static_cast<char*>(pointer);
+		AllocationTracker::onFree(reinterpret_cast<size_t*>(block)[-1]);
+		std::free(block - reinterpret_cast<size_t*>(block)[-2]);
+	}
+
+	void* allocateOrThrow(size_t size, size_t alignment)
+	{
+		if (void* block = allocate(size, alignment))
+		{
+			return block;
+		}
+		throw std::bad_alloc();
+	}
+
+	const bool hooksInstalled = (AllocationTracker::markHooksInstalled(), true);
+}
+
+void* operator new(size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return allocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer); }
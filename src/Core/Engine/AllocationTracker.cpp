@@ -0,0 +1,116 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "AllocationTracker.hpp"
+
+#include <atomic>
+#include <ostream>
+
+namespace sw::core
+{
+	namespace
+	{
+		// zero-initialized before any code runs, operator new may be called during static initialization
+		thread_local AllocationCounters threadCounters;
+		thread_local AllocationPhase threadPhase;
+		std::atomic<bool> hooks{false};
+	}
+
+	uint64_t AllocationCounters::totalAllocations() const noexcept
+	{
+		uint64_t total = 0;
+		for (const uint64_t count : allocations)
+		{
+			total += count;
+		}
+		return total;
+	}
+
+	bool AllocationTracker::hooksInstalled() noexcept
+	{
+		return hooks.load(std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::markHooksInstalled() noexcept
+	{
+		hooks.store(true, std::memory_order_relaxed);
+	}
+
+	const AllocationCounters& AllocationTracker::counters() noexcept
+	{
+		return threadCounters;
+	}
+
+	AllocationPhase AllocationTracker::phase() noexcept
+	{
+		return threadPhase;
+	}
+
+	void AllocationTracker::setPhase(AllocationPhase phase) noexcept
+	{
+		threadPhase = phase;
+	}
+
+	void AllocationTracker::onAllocate(size_t bytes) noexcept
+	{
+		AllocationCounters& counters = threadCounters;
+		const auto phase = static_cast<size_t>(threadPhase);
+		++counters.allocations[phase];
+		counters.bytes[phase] += bytes;
+		counters.liveBytes += static_cast<int64_t>(bytes);
+		counters.peakBytes = counters.liveBytes > counters.peakBytes ? counters.liveBytes : counters.peakBytes;
+	}
+
+	void AllocationTracker::onFree(size_t bytes) noexcept
+	{
+		++threadCounters.frees;
+		threadCounters.liveBytes -= static_cast<int64_t>(bytes);
+	}
+
+	void AllocationTracker::beginRound() noexcept
+	{
+		threadCounters.roundStartTotal = threadCounters.totalAllocations();
+	}
+
+	void AllocationTracker::endRound(uint32_t round) noexcept
+	{
+		AllocationCounters& counters = threadCounters;
+		const uint64_t inRound = counters.totalAllocations() - counters.roundStartTotal;
+		++counters.rounds;
+		counters.allocatingRounds += inRound ? 1 : 0;
+		if (inRound > counters.maxRoundAllocations)
+		{
+			counters.maxRoundAllocations = inRound;
+			counters.maxRound = round;
+		}
+	}
+
+	void AllocationTracker::printReport(std::ostream& stream, uint32_t units)
+	{
+		// copied first, printing allocates
+		const AllocationCounters counters = threadCounters;
+		if (!hooksInstalled())
+		{
+			stream << "Allocations: hooks are not linked in, configure with -DSW_ENABLE_ALLOCATION_HOOKS=ON\n";
+			return;
+		}
+		stream << "Allocations by phase:\n";
+		for (size_t phase = 0; phase < ALLOCATION_PHASES; ++phase)
+		{
+			stream << "  " << ALLOCATION_PHASE_NAMES[phase] << ": " << counters.allocations[phase] << " allocations, "
+				   << counters.bytes[phase] << " bytes\n";
+		}
+		stream << "  frees: " << counters.frees << ", peak " << counters.peakBytes << " bytes live";
+		if (units)
+		{
+			stream << " (" << counters.peakBytes / units << " per unit)";
+		}
+		stream << '\n';
+		if (counters.rounds)
+		{
+			stream << "  rounds: " << counters.rounds << ", " << counters.allocatingRounds << " allocating, max "
+				   << counters.maxRoundAllocations << " in round " << counters.maxRound << '\n';
+		}
+	}
+}
@@ -0,0 +1,92 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_ALLOCATIONTRACKER_HPP
+#define SW_BATTLE_TEST_ALLOCATIONTRACKER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace sw::core
+{
+	// part of the engine an allocation is charged to, set by the engine with AllocationPhaseScope
+	enum class AllocationPhase : uint8_t
+	{
+		Setup, // commands, anything outside of a round
+		Round, // round bookkeeping: action reset, dead unit removal, world hash
+		Turn, // doTurn: the hot loop
+		Exchange, // sharded mode: ghosts, effects and migrants
+		Output, // event flush, snapshot, rendering
+		Count
+	};
+	inline constexpr size_t ALLOCATION_PHASES = static_cast<size_t>(AllocationPhase::Count);
+	inline constexpr std::array<const char*, ALLOCATION_PHASES> ALLOCATION_PHASE_NAMES{"setup", "round", "turn",
+		"exchange", "output"};
+
+	// rounds played before the strict mode starts to count, they fill the reused buffers to their working size
+	inline constexpr uint32_t DEFAULT_ALLOCATION_WARMUP = 3;
+
+	// heap use of one thread; trivially constructible, it lives in thread-local storage read by operator new
+	struct AllocationCounters
+	{
+		std::array<uint64_t, ALLOCATION_PHASES> allocations;
+		std::array<uint64_t, ALLOCATION_PHASES> bytes;
+		uint64_t frees;
+		int64_t liveBytes; // freed blocks allocated before the hooks count too, this may dip below zero
+		int64_t peakBytes;
+		// per round, from AllocationTracker::beginRound / endRound
+		uint64_t rounds;
+		uint64_t allocatingRounds;
+		uint64_t maxRoundAllocations;
+		uint32_t maxRound;
+		uint64_t roundStartTotal; // all allocations when the current round began
+
+		[[nodiscard]] uint64_t totalAllocations() const noexcept;
+	};
+
+	// Heap accounting fed by the global operator new / delete replacements of AllocationHooks.cpp. Only executables
+	// link the hooks in: an engine embedded in another program keeps that program's allocator and sees no counts.
+	// Everything is per thread, engines on other threads do not disturb the counts of this one.
+	class AllocationTracker
+	{
+	public:
+		[[nodiscard]] static bool hooksInstalled() noexcept;
+		static void markHooksInstalled() noexcept;
+
+		// this thread's counters
+		[[nodiscard]] static const AllocationCounters& counters() noexcept;
+		[[nodiscard]] static AllocationPhase phase() noexcept;
+		static void setPhase(AllocationPhase phase) noexcept;
+
+		// called by the hooks
+		static void onAllocate(size_t bytes) noexcept;
+		static void onFree(size_t bytes) noexcept;
+
+		// per round counts cover what happens between these calls
+		static void beginRound() noexcept;
+		static void endRound(uint32_t round) noexcept;
+
+		// per phase counts, per round summary and peak bytes, also per unit when 'units' is not zero
+		static void printReport(std::ostream& stream, uint32_t units);
+	};
+
+	// charges the allocations of the enclosing block to a phase
+	class AllocationPhaseScope
+	{
+		AllocationPhase previous;
+
+	public:
+		explicit AllocationPhaseScope(AllocationPhase phase) noexcept : previous(AllocationTracker::phase())
+		{
+			AllocationTracker::setPhase(phase);
+		}
+		AllocationPhaseScope(const AllocationPhaseScope&) = delete;
+		AllocationPhaseScope& operator=(const AllocationPhaseScope&) = delete;
+		~AllocationPhaseScope() { AllocationTracker::setPhase(previous); }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_ALLOCATIONTRACKER_HPP
@@ -0,0 +1,112 @@
+//
+// Created by Carpov Pavel on 26.10.2025.
+//
+
+#include "BatchRunner.hpp"
+
+#include "Engine.hpp"
+#include "Scenario.hpp"
+#include "TranspositionCache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace sw::core
+{
+	namespace
+	{
+		struct WorkerState
+		{
+			stats::BattleStats stats;
+			uint64_t cacheHits{0};
+			uint64_t cacheMisses{0};
+			uint64_t cacheStores{0};
+			std::exception_ptr error;
+		};
+	}
+
+	BatchResult runBatch(const Scenario& scenario, const BatchConfig& config)
+	{
+		BatchResult result;
+		result.threads = std::clamp<uint32_t>(config.threads, 1, std::max(config.runs, 1u));
+		result.runs.resize(config.runs);
+		// a run stopped at a cached state would produce no events for its tail
+		const size_t cacheEntries = config.collectStats ? 0 : config.cacheEntries;
+
+		std::vector<WorkerState> workers(result.threads);
+		std::atomic<uint32_t> nextRun{0};
+		const auto work = [&](WorkerState& state)
+		{
+			try
+			{
+				// caches are not thread-safe, every worker has its own
+				std::unique_ptr<TranspositionCache> cache;
+				if (cacheEntries)
+				{
+					cache = std::make_unique<TranspositionCache>(cacheEntries);
+				}
+				for (uint32_t i = nextRun++; i < config.runs; i = nextRun++)
+				{
+					Engine run;
+					run.setSeed(config.firstSeed + i);
+					run.getEventLog().setTextEvents({});
+					run.setRoundDelay(std::chrono::milliseconds(0));
+					run.setRoundLimit(config.roundLimit);
+					run.setTranspositionCache(cache.get());
+					if (config.collectStats)
+					{
+						state.stats.attach(run.getEventLog());
+					}
+					scenario.applyTo(run);
+					run.simulateRounds();
+					if (config.collectStats)
+					{
+						state.stats.finishRun(run.getRound());
+					}
+					result.runs[i] = {config.firstSeed + i, run.getRound(), run.getSurvivors(), run.getFinalHash(),
+						run.isResolvedFromCache()};
+				}
+				if (cache)
+				{
+					state.cacheHits = cache->getHits();
+					state.cacheMisses = cache->getMisses();
+					state.cacheStores = cache->getStores();
+				}
+			}
+			catch (...)
+			{
+				state.error = std::current_exception();
+				nextRun = config.runs; // the other workers stop after their current run
+			}
+		};
+
+		const auto started = std::chrono::steady_clock::now();
+		std::vector<std::thread> pool;
+		for (uint32_t t = 1; t < result.threads; ++t)
+		{
+			pool.emplace_back(work, std::ref(workers[t]));
+		}
+		work(workers[0]);
+		for (auto& thread : pool)
+		{
+			thread.join();
+		}
+		result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+
+		for (auto& state : workers)
+		{
+			if (state.error)
+			{
+				std::rethrow_exception(state.error);
+			}
+			result.cacheHits += state.cacheHits;
+			result.cacheMisses += state.cacheMisses;
+			result.cacheStores += state.cacheStores;
+			result.stats.merge(state.stats);
+		}
+		return result;
+	}
+}
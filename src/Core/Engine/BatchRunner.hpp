@@ -0,0 +1,56 @@
+//
+// Created by Carpov Pavel on 26.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_BATCHRUNNER_HPP
+#define SW_BATTLE_TEST_BATCHRUNNER_HPP
+
+#include "IO/Stats/BattleStats.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::core
+{
+	class Scenario;
+
+	struct BatchConfig
+	{
+		uint32_t runs{1};
+		uint64_t firstSeed{0}; // run i is seeded with firstSeed + i
+		uint32_t threads{1};
+		size_t cacheEntries{1 << 16}; // transposition cache per thread, 0 disables
+		uint32_t roundLimit{0};
+		// statistics need every event of every run: turns the cache off
+		bool collectStats{false};
+	};
+
+	struct BatchRun
+	{
+		uint64_t seed{0};
+		uint32_t rounds{0};
+		uint32_t survivors{0};
+		uint64_t finalHash{0};
+		bool cached{false};
+	};
+
+	struct BatchResult
+	{
+		std::vector<BatchRun> runs; // in seed order
+		stats::BattleStats stats;	// merged over all threads when collected
+		uint32_t threads{0};
+		uint64_t cacheHits{0};
+		uint64_t cacheMisses{0};
+		uint64_t cacheStores{0};
+		std::chrono::milliseconds elapsed{0};
+	};
+
+	// Plays the scenario once per seed without text output, spreading the runs over worker threads.
+	// A worker writes only its own stats and cache and the result slots of its runs, nothing is locked; the
+	// per-thread stats are merged once the workers are joined. The first worker error is rethrown
+	BatchResult runBatch(const Scenario& scenario, const BatchConfig& config);
+}
+
+#endif	//SW_BATTLE_TEST_BATCHRUNNER_HPP
@@ -9,6 +9,7 @@
 #include <functional>
 #include <cmath>
 #include <cstddef>
+#include <string>
 
 namespace sw::core
 {
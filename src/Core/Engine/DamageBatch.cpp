@@ -0,0 +1,47 @@
+//
+// Created by Carpov Pavel on 24.10.2025.
+//
+
+#include "DamageBatch.hpp"
+
+#include "IO/Events/UnitAttacked.hpp"
+#include "IO/Events/UnitDied.hpp"
+#include "IO/System/EventLog.hpp"
+#include "Profiler.hpp"
+
+#include <cassert>
+
+namespace sw::core
+{
+	uint32_t DamageBatch::apply(sw::EventLog& eventLog, uint64_t tick, std::vector<GhostEffect>& ghostEffects, SpatialIndex& index)
+	{
+		SW_PROFILE_SCOPE("DamageBatch::apply");
+		died.clear();
+		for (const Entry& entry : entries)
+		{
+			Unit& target = *entry.target;
+			assert(target.hasHp() && "DamageBatch::apply: target has no HP");
+			if (target.isGhost())
+			{
+				target.increaseHp(-static_cast<int32_t>(entry.amount));
+				index.updateWounded(&target);
+				ghostEffects.push_back({GhostEffect::Kind::Damage, entry.attackerId, &target, entry.amount});
+				continue;
+			}
+			const bool wasAlive = target.isAlive();
+			target.increaseHp(-static_cast<int32_t>(entry.amount));
+			index.updateWounded(&target);
+			const uint32_t hp = target.getHp().value();
+			eventLog.emit<sw::io::UnitAttacked>(tick, [&]
+				{ return sw::io::UnitAttacked{entry.attackerId, target.getId(), entry.amount, hp}; });
+			// a unit hit again after its death in the same batch does not die twice
+			if (wasAlive && hp == 0)
+			{
+				died.push_back(&target);
+				eventLog.emit<sw::io::UnitDied>(tick, [&] { return sw::io::UnitDied{target.getId()}; });
+			}
+		}
+		entries.clear();
+		return static_cast<uint32_t>(died.size());
+	}
+}
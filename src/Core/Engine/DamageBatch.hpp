@@ -0,0 +1,73 @@
+//
+// Created by Carpov Pavel on 24.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_DAMAGEBATCH_HPP
+#define SW_BATTLE_TEST_DAMAGEBATCH_HPP
+
+#include "Core/Units/Unit.hpp"
+#include "SpatialIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sw
+{
+	class EventLog;
+}
+
+namespace sw::core
+{
+	// Effect on a ghost (a unit of a neighbouring shard): shown on the local copy at once, applied and logged by the
+	// owning shard after the turn, in the order they happened
+	struct GhostEffect
+	{
+		enum class Kind : uint8_t
+		{
+			Damage,
+			Heal
+		};
+		Kind kind;
+		uint32_t sourceId;
+		Unit* ghost;
+		uint32_t amount;
+	};
+
+	// Damage collected from one action and applied in a single pass. Entries are applied in submission order, so the
+	// event log keeps the per-hit UNIT_ATTACKED / UNIT_DIED order; a unit dies at most once per batch.
+	// Storage is reused between batches, a warm batch does not allocate.
+	class DamageBatch
+	{
+		struct Entry
+		{
+			uint32_t attackerId;
+			Unit* target;
+			uint32_t amount;
+		};
+		std::vector<Entry> entries;
+		std::vector<Unit*> died; // killed by the last apply()
+
+	public:
+		void add(uint32_t attackerId, Unit& target, uint32_t amount) { entries.push_back({attackerId, &target, amount}); }
+		[[nodiscard]] bool empty() const noexcept { return entries.empty(); }
+		[[nodiscard]] size_t size() const noexcept { return entries.size(); }
+		// room for a batch hitting this many units, grown geometrically; called as units are placed, so a turn never
+		// grows the batch (an action hits a unit at most once)
+		void reserve(size_t hits)
+		{
+			if (entries.capacity() < hits)
+			{
+				entries.reserve(std::max(hits, entries.capacity() * 2));
+				died.reserve(entries.capacity());
+			}
+		}
+
+		// applies and logs all entries, then clears the batch; returns the number of units killed by it.
+		// Hits on ghosts are not logged, they go to ghostEffects. Hit units are updated in the wounded lists of the index
+		uint32_t apply(sw::EventLog& eventLog, uint64_t tick, std::vector<GhostEffect>& ghostEffects, SpatialIndex& index);
+		[[nodiscard]] const std::vector<Unit*>& getDied() const noexcept { return died; }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_DAMAGEBATCH_HPP
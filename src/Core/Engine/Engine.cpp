@@ -6,21 +6,32 @@
 
 #include "IO/Commands/SpawnHealer.hpp"
 
+#include "Profiler.hpp"
+
 #include <IO/Events/MapCreated.hpp>
+#include <IO/Events/WorldHash.hpp>
 #include <cassert>
 #include <chrono>
+#include <stdexcept>
 #include <thread>
 
 namespace sw::core
 {
-	std::unique_ptr<Engine> Engine::instance = nullptr;
-
 	MapUnitsController* Engine::getMapUnitsController()
 	{
-		assert(battleMap && "Engine::getMapUnitsController: map not created");
+		if (!battleMap)
+		{
+			throw std::runtime_error("BattleMap is not created, scenario must start with CREATE_MAP");
+		}
 		return battleMap.get();
 	}
 
+	const MapUnitsController& Engine::getMap() const
+	{
+		assert(battleMap && "Engine::getMap: map not created");
+		return *battleMap;
+	}
+
 	void Engine::createMap(uint32_t w, uint32_t h)
     {
         // check if map already exists
@@ -29,29 +40,284 @@ namespace sw::core
             throw std::runtime_error("BattleMap already exists");
         }
         // pass EventLog reference and a callback to obtain current round/tick
-        battleMap = std::make_unique<MapUnitsController>(w, h, eventLog, [this]() { return static_cast<uint64_t>(round); });
-        // emit MapCreated event
-        eventLog.log(round, sw::io::MapCreated{w, h});
+        battleMap = std::make_unique<MapUnitsController>(w, h, eventLog, random, [this]() { return static_cast<uint64_t>(round); });
+        battleMap->tracer = tracer;
+        if (shardConfig)
+        {
+            battleMap->setShard(*shardConfig);
+        }
+        // emit MapCreated event, once for the whole world
+        if (!shardConfig || shardConfig->index == 0)
+        {
+            eventLog.log(round, sw::io::MapCreated{w, h});
+        }
     }
 
+	void Engine::setTraceWriter(sw::TraceWriter* writer)
+	{
+		tracer = writer;
+		if (battleMap)
+		{
+			battleMap->tracer = writer;
+		}
+	}
+
+	void Engine::setRenderer(sw::MapRenderer* renderer_, std::ostream& stream)
+	{
+		renderer = renderer_;
+		renderStream = &stream;
+	}
+
+	void Engine::setShard(const ShardConfig& config, ShardTransport& transport)
+	{
+		if (battleMap)
+		{
+			throw std::runtime_error("Engine::setShard: the map is already created");
+		}
+		shardConfig = config;
+		shardTransport = &transport;
+	}
+
+	bool Engine::isOwnSpawn(uint32_t unitId, uint32_t x, uint32_t y)
+	{
+		const Coordinate cell(static_cast<int32_t>(x), static_cast<int32_t>(y));
+		if (getMapUnitsController()->ownsCell(cell))
+		{
+			return true;
+		}
+		foreignUnits.insert(unitId);
+		return false;
+	}
+
+	void Engine::setStrictAllocations(std::optional<uint32_t> warmupRounds)
+	{
+		if (warmupRounds && !AllocationTracker::hooksInstalled())
+		{
+			throw std::runtime_error("Strict allocations need the allocation hooks linked in");
+		}
+		strictAllocationsAfter = warmupRounds;
+	}
+
+	uint32_t Engine::playTurn()
+	{
+		const AllocationCounters& counters = AllocationTracker::counters();
+		const uint64_t allocationsBefore = counters.allocations[static_cast<size_t>(AllocationPhase::Turn)];
+		const uint64_t bytesBefore = counters.bytes[static_cast<size_t>(AllocationPhase::Turn)];
+		uint32_t actions = 0;
+		{
+			AllocationPhaseScope turnPhase(AllocationPhase::Turn);
+			actions = getMapUnitsController()->doTurn();
+		}
+		if (strictAllocationsAfter && round > *strictAllocationsAfter)
+		{
+			const uint64_t allocations = counters.allocations[static_cast<size_t>(AllocationPhase::Turn)] - allocationsBefore;
+			if (allocations)
+			{
+				const uint64_t bytes = counters.bytes[static_cast<size_t>(AllocationPhase::Turn)] - bytesBefore;
+				throw std::runtime_error("Strict allocations: doTurn of round " + std::to_string(round) + " allocated " +
+					std::to_string(allocations) + " times, " + std::to_string(bytes) + " bytes");
+			}
+		}
+		return actions;
+	}
+
+	void Engine::setSnapshotWriter(sw::snapshot::SnapshotWriter* writer)
+	{
+		snapshotWriter = writer;
+		if (snapshotWriter && battleMap)
+		{
+			snapshotWriter->publish(*battleMap, round);
+		}
+	}
+
+	bool Engine::playShardRound()
+	{
+		SW_PROFILE_SCOPE("Engine::simulateRounds/round");
+		MapUnitsController* map = getMapUnitsController();
+		map->handleNextRound();
+		round++;
+		map->removeDeadUnits();
+		ShardTotals start;
+		{
+			// the neighbours' border units as they are at the start of the round
+			AllocationPhaseScope exchangePhase(AllocationPhase::Exchange);
+			map->writeGhosts(shardOutgoing);
+			shardTransport->exchange(shardOutgoing, shardIncoming);
+			map->readGhosts(shardIncoming);
+			start = shardTransport->reduce(ShardTotals{.units = map->getUnitsCount()});
+		}
+		const uint32_t actions = start.units == 1 ? 0 : playTurn();
+		ShardTotals end;
+		{
+			// owners apply what the ghosts took, then units that crossed a border change shard
+			AllocationPhaseScope exchangePhase(AllocationPhase::Exchange);
+			map->writeGhostEffects(shardOutgoing);
+			shardTransport->exchange(shardOutgoing, shardIncoming);
+			map->readGhostEffects(shardIncoming);
+			map->writeEmigrants(shardOutgoing);
+			shardTransport->exchange(shardOutgoing, shardIncoming);
+			map->readImmigrants(shardIncoming);
+			end = shardTransport->reduce(ShardTotals{.actions = actions, .worldHash = map->getWorldHash()});
+		}
+		if (worldHashEvents && shardConfig->index == 0)
+		{
+			eventLog.emit<sw::io::WorldHash>(round, [&end] { return sw::io::WorldHash{end.worldHash}; });
+		}
+		const bool noMoreActions = start.units == 1 || end.actions == 0;
+		limitReached = !noMoreActions && roundLimit && round >= roundLimit;
+		return noMoreActions || limitReached;
+	}
+
+	bool Engine::playRound()
+	{
+		if (shardTransport)
+		{
+			return playShardRound();
+		}
+		if (cache)
+		{
+			// the rest of the run depends on nothing but the units and the generator
+			const uint64_t worldHash = getMapUnitsController()->getWorldHash();
+			const uint64_t randomState = random.getStateHash();
+			const auto known = cache->find(worldHash, randomState);
+			if (known && (!roundLimit || round + known->roundsLeft <= roundLimit))
+			{
+				round += known->roundsLeft;
+				survivors = known->survivors;
+				finalHash = known->finalHash;
+				resolvedFromCache = true;
+				return true;
+			}
+			cacheTrail.push_back({worldHash, randomState, random.getDrawCount(), round});
+		}
+		const uint64_t eventsBefore = eventLog.getEventsLogged();
+		const uint64_t bytesBefore = eventLog.getBytesLogged();
+		SW_PROFILE_SCOPE("Engine::simulateRounds/round");
+		TraceSpan roundSpan(tracer, "round", {"round", round + 1});
+		getMapUnitsController()->handleNextRound();
+		// advance round counter early, so the 1st round only has spawn events
+		round++;
+		getMapUnitsController()->removeDeadUnits();
+		const bool noMoreActions = getMapUnitsController()->getUnitsCount() == 1 || playTurn() == 0;
+		if (worldHashEvents)
+		{
+			eventLog.emit<sw::io::WorldHash>(round, [this] { return sw::io::WorldHash{getMapUnitsController()->getWorldHash()}; });
+		}
+		if (tracer)
+		{
+			tracer->addCounter("livingUnits", getMapUnitsController()->getUnitsCount());
+			tracer->addCounter("eventsEmitted", static_cast<int64_t>(eventLog.getEventsLogged() - eventsBefore));
+			tracer->addCounter("bytesLogged", static_cast<int64_t>(eventLog.getBytesLogged() - bytesBefore));
+		}
+		limitReached = !noMoreActions && roundLimit && round >= roundLimit;
+		return noMoreActions || limitReached;
+	}
+
+	void Engine::finish()
+	{
+		finished = true;
+		if (snapshotWriter)
+		{
+			snapshotWriter->finish();
+		}
+		if (shardTransport)
+		{
+			const ShardTotals totals = shardTransport->reduce(ShardTotals{
+				.living = getMapUnitsController()->getLivingUnitsCount(), .worldHash = getMapUnitsController()->getWorldHash()});
+			survivors = static_cast<uint32_t>(totals.living);
+			finalHash = totals.worldHash;
+		}
+		else if (!resolvedFromCache)
+		{
+			survivors = getMapUnitsController()->getLivingUnitsCount();
+			finalHash = getMapUnitsController()->getWorldHash();
+		}
+		if (cache)
+		{
+			// a run cut by the round limit has no outcome to share
+			if (!limitReached)
+			{
+				const uint64_t draws = random.getDrawCount();
+				for (const auto& entry : cacheTrail)
+				{
+					const BattleOutcome outcome{round - entry.round, survivors, finalHash};
+					// after a cache hit the draws of the cached tail are unknown, only exact entries are safe
+					if (!resolvedFromCache && entry.randomDraws == draws)
+					{
+						cache->storeRandomFree(entry.worldHash, outcome);
+					}
+					else
+					{
+						cache->store(entry.worldHash, entry.randomState, outcome);
+					}
+				}
+			}
+			cacheTrail.clear();
+		}
+	}
+
+	bool Engine::advance()
+	{
+		if (finished)
+		{
+			return false;
+		}
+		AllocationPhaseScope roundPhase(AllocationPhase::Round);
+		AllocationTracker::beginRound();
+		const bool over = playRound();
+		if (snapshotWriter)
+		{
+			AllocationPhaseScope outputPhase(AllocationPhase::Output);
+			snapshotWriter->publish(*getMapUnitsController(), round);
+		}
+		AllocationTracker::endRound(round);
+		if (over)
+		{
+			finish();
+			return false;
+		}
+		return true;
+	}
+
+	bool Engine::step(uint32_t rounds)
+	{
+		for (uint32_t i = 0; i < rounds && advance(); ++i)
+		{
+		}
+		// an embedding caller reads the stream between steps
+		AllocationPhaseScope outputPhase(AllocationPhase::Output);
+		eventLog.flush();
+		return !finished;
+	}
+
 	void Engine::simulateRounds()
     {
-	    while (true)
+	    if (renderer)
 	    {
-	    	getMapUnitsController()->handleNextRound();
-	    	// advance round counter early, so the 1st round only has spawn events
-	    	round++;
-			getMapUnitsController()->removeDeadUnits();
-	    	if (getMapUnitsController()->getUnitsCount()==1 || getMapUnitsController()->doTurn() == 0)
+		    renderer->draw(*getMapUnitsController(), *renderStream, true);
+	    }
+	    while (advance())
+	    {
+		    AllocationPhaseScope outputPhase(AllocationPhase::Output);
+		    if (renderer)
 		    {
-			    // debugPrint("No actions performed in this round, ending simulation.");
-			    break;
+			    renderer->draw(*getMapUnitsController(), *renderStream);
 		    }
 
-	    	// getMapUnitsController()->printMap();
-
 		    // sleep a short amount
-		    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		    if (roundDelay.count() > 0)
+		    {
+			    // the round is watched live, its events must be visible before the pause
+			    eventLog.flush();
+			    std::this_thread::sleep_for(roundDelay);
+		    }
+	    }
+	    AllocationPhaseScope outputPhase(AllocationPhase::Output);
+	    eventLog.flush();
+	    if (renderer)
+	    {
+		    // final state is always shown, even if the last frames were dropped
+		    renderer->draw(*getMapUnitsController(), *renderStream, true);
 	    }
     }
 
@@ -60,6 +326,23 @@ namespace sw::core
         createMap(cmd.width, cmd.height);
     }
 
+    void Engine::handleCommand(const sw::io::SpawnUnit& cmd, const UnitDefinition& definition)
+    {
+    	if (!isOwnSpawn(cmd.unitId, cmd.x, cmd.y))
+    	{
+    		return;
+    	}
+    	if (definition.plan)
+    	{
+    		getMapUnitsController()->placeUnit(UnitFactory::createPlanned(cmd, definition));
+    	}
+    	else
+    	{
+    		getMapUnitsController()->placeUnit(UnitFactory::create(cmd, definition));
+    	}
+    	eventLog.log(round, sw::io::UnitSpawned{cmd.unitId, definition.name, cmd.x, cmd.y});
+    }
+
     void Engine::handleCommand(const sw::io::SpawnSwordsman& cmd)
     {
     	handleSpawn(cmd, std::string("Swordsman"));
@@ -82,6 +365,10 @@ namespace sw::core
 
     void Engine::handleCommand(const sw::io::March& cmd /*cmd*/)
     {
+    	if (foreignUnits.contains(cmd.unitId))
+    	{
+    		return;
+    	}
     	getMapUnitsController()->assignMarchCommand(cmd.unitId, cmd.targetX, cmd.targetY);
     }
 
@@ -8,35 +8,42 @@
 #include "IO/Commands/SpawnHealer.hpp"
 #include "IO/Commands/SpawnMine.hpp"
 #include "IO/Events/UnitSpawned.hpp"
+#include "AllocationTracker.hpp"
 #include "MapUnitsController.hpp"
+#include "Random.hpp"
+#include "ShardLayout.hpp"
+#include "ShardTransport.hpp"
+#include "TranspositionCache.hpp"
 
 #include <Core/Units/Unit.hpp>
 #include <Core/Units/UnitFactory.hpp>
 #include <IO/Commands/CreateMap.hpp>
 #include <IO/Commands/March.hpp>
 #include <IO/System/EventLog.hpp>
+#include <IO/System/MapRenderer.hpp>
+#include <IO/Snapshot/WorldSnapshot.hpp>
+#include <IO/System/TraceWriter.hpp>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace sw::core
 {
-	// Singleton Engine class that processes commands and manages game state
+	// Processes commands and manages the state of one battle. Everything a battle touches, the random generator
+	// included, belongs to its engine, so any number of engines can run side by side on different threads.
+	// Embedding: handle the scenario commands, then either simulateRounds() or drive it with step() / runUntil()
     class Engine
     {
-    	static std::unique_ptr<Engine> instance;
     public:
-    	static Engine* getInstance()
-    	{
-    		if (!instance)
-			{
-				instance.reset(new Engine());
-			}
-    		return instance.get();
-    	}
-
+    	// events are written to the given stream (stdout by default)
+    	explicit Engine(std::ostream& eventStream = std::cout) : eventLog(eventStream) {}
     	~Engine() = default;
+    	Engine(const Engine&) = delete;
+    	Engine& operator=(const Engine&) = delete;
 
         // Command handlers
         void handleCommand(const sw::io::CreateMap& cmd);
@@ -45,24 +52,119 @@ namespace sw::core
         void handleCommand(const sw::io::SpawnMine& cmd);
         void handleCommand(const sw::io::SpawnHealer& cmd);
         void handleCommand(const sw::io::March& cmd);
+        // kinds from the definitions file, the scenario binds each spawn to its definition while parsing
+        void handleCommand(const sw::io::SpawnUnit& cmd, const UnitDefinition& definition);
 
+    	// runs the battle to its end, drawing frames and pausing between rounds if asked to
     	void simulateRounds();
+    	// plays up to 'rounds' rounds and flushes the events; false once the battle is over
+    	bool step(uint32_t rounds = 1);
+    	// plays rounds until the battle is over or pred(const Engine&) holds after a round; true if it is over
+    	template <typename TPredicate>
+    	bool runUntil(TPredicate&& pred)
+    	{
+    		while (advance() && !pred(static_cast<const Engine&>(*this)))
+    		{
+    		}
+    		eventLog.flush();
+    		return finished;
+    	}
+    	[[nodiscard]] bool isFinished() const noexcept { return finished; }
+    	// read-only view of the battle map, the map must be created already
+    	[[nodiscard]] const MapUnitsController& getMap() const;
+    	// attach a timeline recorder (not owned), nullptr disables tracing
+    	void setTraceWriter(sw::TraceWriter* writer);
+    	// attach a live map view (not owned) redrawn after every round, nullptr disables rendering
+    	void setRenderer(sw::MapRenderer* renderer_, std::ostream& stream = std::cerr);
+    	// publish the world into a snapshot segment (not owned) now and after every round, nullptr disables
+    	void setSnapshotWriter(sw::snapshot::SnapshotWriter* writer);
+    	// pause between rounds, keeps the simulation watchable; zero runs at full speed
+    	void setRoundDelay(std::chrono::milliseconds delay) noexcept { roundDelay = delay; }
+    	// stop the simulation after this round even if units can still act, 0 = no limit
+    	void setRoundLimit(uint32_t limit) noexcept { roundLimit = limit; }
+    	[[nodiscard]] uint32_t getRound() const noexcept { return round; }
+    	// restarts the generator, engines given the same seed and scenario play the same battle
+    	void setSeed(uint64_t seed) noexcept { random.reseed(seed); }
+    	[[nodiscard]] const Random& getRandom() const noexcept { return random; }
+    	// log WORLD_HASH with the world hash at the end of every round, to find where two runs diverge
+    	void setWorldHashEvents(bool enabled) noexcept { worldHashEvents = enabled; }
+    	// fail the run (std::runtime_error) if doTurn allocates once 'warmupRounds' rounds are played, nullopt disables;
+    	// needs the allocation hooks (AllocationTracker.hpp)
+    	void setStrictAllocations(std::optional<uint32_t> warmupRounds);
+    	// share known outcomes between runs (not owned), nullptr disables. A run reaching a cached state stops there:
+    	// the round counter jumps to the known last round and the remaining events are not produced
+    	void setTranspositionCache(TranspositionCache* cache_) noexcept { cache = cache_; }
+    	// play one region of a sharded battle (ShardLayout.hpp), before CREATE_MAP. Every shard handles the whole
+    	// scenario and keeps what spawns in its region; the transport (not owned) links it with the others, which
+    	// must be set up the same way. Outcome and world hash cover the whole world, the transposition cache is unused
+    	void setShard(const ShardConfig& config, ShardTransport& transport);
+    	// how the last simulateRounds() ended
+    	[[nodiscard]] uint32_t getSurvivors() const noexcept { return survivors; }
+    	[[nodiscard]] uint64_t getFinalHash() const noexcept { return finalHash; }
+    	[[nodiscard]] bool isResolvedFromCache() const noexcept { return resolvedFromCache; }
+    	[[nodiscard]] const EventLog& getEventLog() const noexcept { return eventLog; }
+    	// subscribe sinks / narrow the text output before the first command is handled
+    	[[nodiscard]] EventLog& getEventLog() noexcept { return eventLog; }
     private:
 		std::unique_ptr<MapUnitsController> battleMap;
 		uint32_t round{1};
 
     	MapUnitsController* getMapUnitsController();
+    	// one round; true if the battle is over after it
+    	bool playRound();
+    	bool playShardRound();
+    	// doTurn charged to AllocationPhase::Turn, checked in the strict mode
+    	uint32_t playTurn();
+    	// plays a round unless the battle is over, closes the battle after its last round; false once it is over
+    	bool advance();
+    	void finish();
 
         void debugPrint(const std::string& msg) const { std::cout << msg << std::endl; }
     	void createMap(uint32_t width, uint32_t height);
 
 		EventLog eventLog; // log/emitter for produced events
+		Random random; // seeded from std::random_device unless setSeed() is called
+		sw::TraceWriter* tracer{nullptr};
+		sw::MapRenderer* renderer{nullptr};
+		std::ostream* renderStream{&std::cerr};
+		sw::snapshot::SnapshotWriter* snapshotWriter{nullptr};
+		std::chrono::milliseconds roundDelay{500};
+		uint32_t roundLimit{0};
+		bool worldHashEvents{false};
+		std::optional<uint32_t> strictAllocationsAfter;
+		TranspositionCache* cache{nullptr};
+		// states met by the current run, they get its outcome once it is known
+		struct CacheTrailEntry
+		{
+			uint64_t worldHash;
+			uint64_t randomState;
+			uint64_t randomDraws; // drawn before the state, equal to the final count if the rest is RNG-free
+			uint32_t round;
+		};
+		std::vector<CacheTrailEntry> cacheTrail;
+		bool finished{false};
+		bool limitReached{false};
+		uint32_t survivors{0};
+		uint64_t finalHash{0};
+		bool resolvedFromCache{false};
+		std::optional<ShardConfig> shardConfig;
+		ShardTransport* shardTransport{nullptr};
+		// spawned in other regions: their commands are for the other shards
+		std::unordered_set<uint32_t> foreignUnits;
+		std::vector<std::string> shardOutgoing;
+		std::vector<std::string> shardIncoming;
+
+		// false (and the id remembered) when the cell belongs to another shard
+		bool isOwnSpawn(uint32_t unitId, uint32_t x, uint32_t y);
 
         template <typename TCommand>
         void handleSpawn(const TCommand& cmd, const std::string& unitType)
         {
-            auto unit = UnitFactory::create(cmd);
-            getMapUnitsController()->placeUnit(std::move(unit));
+            if (!isOwnSpawn(cmd.unitId, cmd.x, cmd.y))
+            {
+                return;
+            }
+            getMapUnitsController()->placeUnit(UnitFactory::create(cmd));
 
             eventLog.log(round, sw::io::UnitSpawned{cmd.unitId, unitType, cmd.x, cmd.y});
         }
@@ -4,17 +4,19 @@
 
 #include "MapUnitsController.hpp"
 
-#include "Action.hpp"
-#include "Core/Units/MovingUnit.hpp"
 #include "IO/Events/MarchEnded.hpp"
 #include "IO/Events/MarchStarted.hpp"
 #include "IO/Events/UnitAttacked.hpp"
 #include "IO/Events/UnitDied.hpp"
+#include "IO/Events/UnitHealed.hpp"
 #include "IO/Events/UnitMoved.hpp"
 #include "IO/System/EventLog.hpp"
-#include "Util.hpp"
+#include "Core/Units/UnitArchive.hpp"
+#include "Profiler.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <random>
 #include <unordered_set>
 
@@ -23,60 +25,53 @@ namespace sw::core
 
 	bool MapUnitsController::isOccupied(const Coordinate& c) const
 	{
-		for (const auto& unit : units)
-		{
-			if (unit.second->getPosition() == c && unit.second->isSolid())
-			{
-				return true;
-			}
-		}
-		return false;
+		return spatialIndex.findSolidAt(c) != nullptr;
 	}
 
-	// Places unit on the map. Steals ownership
-	void MapUnitsController::placeUnit(std::unique_ptr<Unit> unit)
+	void MapUnitsController::moveUnit(Unit& unit, const Coordinate& to)
 	{
-		assert(unit && "MapUnitsController::placeUnit: null unit");
-		// check position validity
-		const Coordinate& pos = unit->getPosition();
-		assert(isValidCoordinate(pos) && "MapUnitsController::placeUnit: invalid unit position");
-		uint32_t id = unit->getId();
-		if (units.find(id) != units.end())
-		{
-			throw std::runtime_error("BattleMap::placeUnit: unit with same id already exists");
-		}
-		// store ownership: convert unique_ptr -> shared_ptr
-		units[id] = std::move(unit);
+		assert(isValidCoordinate(to) && "MapUnitsController::moveUnit: invalid target position");
+		spatialIndex.relocate(&unit, to);
+		unit.setPosition(to);
+		planScheduler.unitAt(unit);
 	}
 
 	void MapUnitsController::handleNextRound()
 	{
+		SW_PROFILE_SCOPE("MapUnitsController::handleNextRound");
 		// reset available actions for all units
-		for (auto& [id, unit] : units)
-		{
-			unit->setAvailableActionsPerTurn(unit->getDefaultUnitActionsPerTurn());
-		}
+		units.forEachUnit([](Unit& unit) { unit.setAvailableActionsPerTurn(Unit::getDefaultUnitActionsPerTurn()); });
 	}
 
 	bool MapUnitsController::assignMarchCommand(uint32_t unitId, int32_t targetX, int32_t targetY)
 	{
 		// find unit by id
-		auto it = units.find(unitId);
-		if (it == units.end())
-		{
-			throw std::runtime_error("BattleMap: No unit found");
-		}
-		auto movingUnit = std::dynamic_pointer_cast<MovingUnit>(it->second);
-		if (!movingUnit)
+		const bool found = units.visit(unitId, [&](auto& unit)
 		{
+			if constexpr (std::remove_reference_t<decltype(unit)>::template has<MoveBehaviour>)
+			{
+				if (unit.template uses<MoveBehaviour>())
+				{
+					unit.setTarget(Coordinate(static_cast<int32_t>(targetX), static_cast<int32_t>(targetY)));
+					if constexpr (requires { unit.wakePlan(planScheduler); })
+					{
+						unit.wakePlan(planScheduler);
+					}
+					return;
+				}
+			}
 			throw std::runtime_error("BattleMap: No moving unit found");
+		});
+		if (!found)
+		{
+			throw std::runtime_error("BattleMap: No unit found");
 		}
-		movingUnit->setTarget(Coordinate(static_cast<int32_t>(targetX), static_cast<int32_t>(targetY)));
 		return true;
 	}
 
 	std::vector<Coordinate> MapUnitsController::getCoordinatesInRange(const Coordinate& position, uint32_t range_max, uint32_t range_min) const
 	{
+		SW_PROFILE_SCOPE("MapUnitsController::getCoordinatesInRange");
 		std::vector<Coordinate> coordinates;
 		coordinates.reserve((range_max * 2 + 1) * (range_max * 2 + 1)); // reserve enough to avoid reallocations
 		for (int32_t dx = -static_cast<int32_t>(range_max); dx <= static_cast<int32_t>(range_max); dx++)
@@ -98,62 +93,282 @@ namespace sw::core
 		return coordinates;
 	}
 
-	std::vector< std::shared_ptr<Unit> > MapUnitsController::getUnitsInRange(const Coordinate& position, const uint32_t range_max, const uint32_t range_min) const
+	uint32_t MapUnitsController::getLivingUnitsCount() const
+	{
+		uint32_t living = 0;
+		units.forEachUnit([&living](const Unit& unit) { living += unit.isAlive() ? 1 : 0; });
+		return living;
+	}
+
+	uint32_t MapUnitsController::removeDeadUnits()
 	{
-		// loop thru units
-		std::vector< std::shared_ptr<Unit> > result;
-		result.reserve(units.size()); // reserve enough to avoid reallocations
-		for (const auto& [id, unit] : units)
+		SW_PROFILE_SCOPE("MapUnitsController::removeDeadUnits");
+		return static_cast<uint32_t>(units.eraseIf([this](auto& unit)
 		{
-			uint32_t distance = position.distance(unit->getPosition());
-			if (distance <= range_max && distance >= range_min)
+			if (unit.isAlive())
 			{
-				result.emplace_back(unit);
+				return false;
 			}
+			if constexpr (requires { unit.stopPlan(planScheduler); })
+			{
+				unit.stopPlan(planScheduler);
+			}
+			spatialIndex.remove(&unit);
+			unit.attachHash(nullptr);
+			return true;
+		}));
+	}
+
+	void MapUnitsController::heal(uint32_t healerId, Unit& target, uint32_t amount)
+	{
+		target.increaseHp(static_cast<int32_t>(std::min(amount, target.getMissingHp())));
+		spatialIndex.updateWounded(&target);
+		if (target.isGhost())
+		{
+			ghostEffects.push_back({GhostEffect::Kind::Heal, healerId, &target, amount});
+			return;
 		}
-		return result;
+		eventLog_.emit<sw::io::UnitHealed>(getCurrentTick(), [&]
+			{ return sw::io::UnitHealed{healerId, target.getId(), amount, target.getHp().value()}; });
 	}
 
-	uint32_t MapUnitsController::removeDeadUnits()
+	void MapUnitsController::setShard(const ShardConfig& config)
 	{
-		return std::erase_if(units, [](const auto& pair) { return !pair.second->isAlive(); });
+		const ShardLayout layout(config, width, height);
+		ShardView view;
+		view.region = layout.getRegion(config.index);
+		view.neighbours = ShardLayout::neighboursOf(config.columns, config.rows, config.index);
+		for (const uint32_t neighbour : view.neighbours)
+		{
+			view.neighbourRegions.push_back(layout.getRegion(neighbour));
+			view.ghostBoxes.push_back(view.region.intersect(view.neighbourRegions.back().grown(config.halo)));
+		}
+		shard = std::move(view);
 	}
 
-	void MapUnitsController::printMap()
-	{// print the map with 3 characters per cell
-		for (uint32_t y = 0; y < height; ++y)
+	void MapUnitsController::writeGhosts(std::vector<std::string>& outgoing) const
+	{
+		SW_PROFILE_SCOPE("MapUnitsController::writeGhosts");
+		outgoing.resize(shard->neighbours.size());
+		for (size_t slot = 0; slot < outgoing.size(); ++slot)
 		{
-			for (uint32_t x = 0; x < width; ++x)
+			outgoing[slot].clear();
+			UnitArchiveWriter writer(outgoing[slot]);
+			const Region& box = shard->ghostBoxes[slot];
+			if (box.empty())
 			{
-				Coordinate c(x, y);
-				auto units = getUnitsInRange(c, 0,0);
-				// print first 2 letters of unit name or [  ] if empty
-				auto unitsHere = getUnitsInRange(c, 0,0);
-				std::cout << (units.size() ? "["+units.back()->getShortName()+"]" : "[  ]");
+				continue;
 			}
-			std::cout << std::endl;
+			// ghosts of the neighbours lie outside the region, the box only holds own units
+			spatialIndex.forEachInBox(box.minX, box.minY, box.maxX, box.maxY, LAYER_ALL, [&writer](const Unit* unit)
+			{
+				const_cast<Unit*>(unit)->transfer(writer);
+			});
 		}
 	}
 
+	void MapUnitsController::readGhosts(const std::vector<std::string>& incoming)
+	{
+		SW_PROFILE_SCOPE("MapUnitsController::readGhosts");
+		assert(ghosts.empty() && "MapUnitsController::readGhosts: ghosts of the last round are still indexed");
+		for (size_t slot = 0; slot < incoming.size(); ++slot)
+		{
+			UnitArchiveReader reader(incoming[slot].data(), incoming[slot].size());
+			while (!reader.atEnd())
+			{
+				Unit& ghost = ghosts.emplace_back(true);
+				ghost.transfer(reader);
+				ghost.markGhost();
+				ghostSources.push_back(static_cast<uint8_t>(slot));
+			}
+		}
+		// indexed once all are read, the vector does not move them any more
+		for (Unit& ghost : ghosts)
+		{
+			spatialIndex.insert(&ghost);
+			planScheduler.unitAt(ghost);
+		}
+	}
+
+	void MapUnitsController::writeGhostEffects(std::vector<std::string>& outgoing)
+	{
+		outgoing.resize(shard->neighbours.size());
+		for (std::string& message : outgoing)
+		{
+			message.clear();
+		}
+		for (const GhostEffect& effect : ghostEffects)
+		{
+			const auto slot = ghostSources[static_cast<size_t>(effect.ghost - ghosts.data())];
+			UnitArchiveWriter writer(outgoing[slot]);
+			writer.field(effect.kind);
+			writer.field(effect.sourceId);
+			writer.field(effect.ghost->getId());
+			writer.field(effect.amount);
+		}
+		ghostEffects.clear();
+		// the ghosts served their turn; they go before the migration, an arriving unit may share the id of one
+		for (Unit& ghost : ghosts)
+		{
+			spatialIndex.remove(&ghost);
+		}
+		ghosts.clear();
+		ghostSources.clear();
+	}
+
+	void MapUnitsController::readGhostEffects(const std::vector<std::string>& incoming)
+	{
+		SW_PROFILE_SCOPE("MapUnitsController::readGhostEffects");
+		for (const std::string& message : incoming)
+		{
+			UnitArchiveReader reader(message.data(), message.size());
+			while (!reader.atEnd())
+			{
+				GhostEffect::Kind kind{};
+				uint32_t sourceId = 0;
+				uint32_t targetId = 0;
+				uint32_t amount = 0;
+				reader.field(kind);
+				reader.field(sourceId);
+				reader.field(targetId);
+				reader.field(amount);
+				// the target may have died or left since the copy was made, the effect is then lost
+				units.visit(targetId, [&](auto& unit)
+				{
+					if (kind == GhostEffect::Kind::Heal)
+					{
+						heal(sourceId, unit, amount);
+						return;
+					}
+					damageBatch.add(sourceId, unit, amount);
+					applyDamage();
+				});
+			}
+		}
+	}
+
+	void MapUnitsController::writeEmigrants(std::vector<std::string>& outgoing)
+	{
+		SW_PROFILE_SCOPE("MapUnitsController::writeEmigrants");
+		outgoing.resize(shard->neighbours.size());
+		for (std::string& message : outgoing)
+		{
+			message.clear();
+		}
+		units.eraseIf([this, &outgoing](auto& unit)
+		{
+			if (shard->region.contains(unit.getPosition()))
+			{
+				return false;
+			}
+			using TArchetype = std::remove_reference_t<decltype(unit)>;
+			// the dead stay behind, removeDeadUnits would drop them anyway
+			if (unit.isAlive())
+			{
+				const auto& regions = shard->neighbourRegions;
+				const auto to = std::find_if(regions.begin(), regions.end(), [&unit](const Region& region)
+					{ return region.contains(unit.getPosition()); });
+				if (to == regions.end())
+				{
+					throw std::runtime_error("BattleMap: unit moved past the neighbouring regions, the halo is too small");
+				}
+				const auto slot = static_cast<size_t>(to - regions.begin());
+				UnitArchiveWriter writer(outgoing[slot]);
+				writer.field(UnitArchetypeStorage::archetypeIndex<TArchetype>());
+				unit.transfer(writer);
+			}
+			if constexpr (requires { unit.stopPlan(planScheduler); })
+			{
+				unit.stopPlan(planScheduler);
+			}
+			spatialIndex.remove(&unit);
+			unit.attachHash(nullptr);
+			return true;
+		});
+	}
+
+	void MapUnitsController::readImmigrants(const std::vector<std::string>& incoming)
+	{
+		SW_PROFILE_SCOPE("MapUnitsController::readImmigrants");
+		for (const std::string& message : incoming)
+		{
+			UnitArchiveReader reader(message.data(), message.size());
+			while (!reader.atEnd())
+			{
+				uint8_t archetype = 0;
+				reader.field(archetype);
+				const bool known = UnitArchetypeStorage::withArchetype(archetype, [this, &reader](auto type)
+				{
+					using TArchetype = typename decltype(type)::type;
+					TArchetype unit = TArchetype::restore(reader);
+					if (!ownsCell(unit.getPosition()))
+					{
+						throw std::runtime_error("BattleMap: arriving unit is outside of the region");
+					}
+					// two shards may have moved units onto the same border cell in one round
+					if (unit.isSolid() && isOccupied(unit.getPosition()))
+					{
+						const auto freeCell = findFreeCellNear(unit.getPosition());
+						if (!freeCell)
+						{
+							throw std::runtime_error("BattleMap: no free cell for an arriving unit");
+						}
+						unit.setPosition(*freeCell);
+						eventLog_.emit<sw::io::UnitMoved>(getCurrentTick(), [&]
+							{ return sw::io::UnitMoved{unit.getId(), static_cast<uint32_t>(freeCell->getX()), static_cast<uint32_t>(freeCell->getY())}; });
+					}
+					placeUnit(std::move(unit));
+				});
+				if (!known)
+				{
+					throw std::runtime_error("BattleMap: unknown archetype in a shard message");
+				}
+			}
+		}
+	}
+
+	std::optional<Coordinate> MapUnitsController::findFreeCellNear(const Coordinate& c) const
+	{
+		const Region& region = shard->region;
+		const int32_t reach = std::max(region.maxX - region.minX, region.maxY - region.minY);
+		for (int32_t r = 1; r <= reach; ++r)
+		{
+			for (int32_t dx = -r; dx <= r; ++dx)
+			{
+				for (int32_t dy = -r; dy <= r; ++dy)
+				{
+					const Coordinate cell(c.getX() + dx, c.getY() + dy);
+					// the ring only
+					if (std::max(std::abs(dx), std::abs(dy)) == r && region.contains(cell) && !isOccupied(cell))
+					{
+						return cell;
+					}
+				}
+			}
+		}
+		return std::nullopt;
+	}
+
 	uint32_t MapUnitsController::doTurn()
 	{
+		SW_PROFILE_SCOPE("MapUnitsController::doTurn");
 		uint32_t result{};
-		// loop thru units and let them act
-		for (auto& [id, unit] : units)
+		// loop thru units in id order, each one runs the action order of its archetype
+		units.forEach([this, &result](auto& unit)
 		{
 			// check for units that were killed during this round and not yet removed
-			if (!unit->isAlive())
+			if (!unit.isAlive())
 			{
-				continue; // skip dead units
+				return; // skip dead units
 			}
-			while (unit->getAvailableActionsPerTurn() > 0)
+			while (unit.getAvailableActionsPerTurn() > 0)
 			{
-				if (unit->tryToExecuteNextAction(*this))
+				if (unit.tryToExecuteNextAction(*this))
 				{
 					result++;
 				}
 			}
-		}
+		});
 		return result;
 	}
 	//
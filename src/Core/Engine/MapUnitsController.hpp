@@ -6,14 +6,31 @@
 #define SW_BATTLE_TEST_BATTLEMAP_HPP
 
 #include "Coordinate.hpp"
+#include "DamageBatch.hpp"
+#include "PlanScheduler.hpp"
+#include "Random.hpp"
+#include "Core/Units/ConcreteUnits.hpp"
 #include "Core/Units/Unit.hpp"
+#include "ShardLayout.hpp"
+#include "SpatialIndex.hpp"
+#include "UnitQuery.hpp"
+#include "ZobristHash.hpp"
 
+#include <cassert>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-namespace sw { class EventLog; }
+namespace sw
+{
+	class EventLog;
+	class TraceWriter;
+}
 
 namespace sw::core
 {
@@ -21,27 +38,84 @@ namespace sw::core
 	class MapUnitsController
 	{
 		friend class Engine;
-		// No matrix or grid for now. Just dimensions and a flat collection of units.
+		// No dense grid: units are owned per archetype and located through a sparse chunked index, so nothing scales with W*H
 		uint32_t width{};
 		uint32_t height{};
-		std::map<uint32_t, std::shared_ptr<Unit> > units; // store units by id (controller owns units)
+		UnitArchetypeStorage units; // controller owns units, the turn order is by id
+		SpatialIndex spatialIndex; // non-owning, chunks are allocated only where units are
+		Random& random; // generator of the owning engine
 		// callback to obtain current tick/round from owner (Engine)
 		std::function<uint64_t()> getCurrentTick_;
+		// optional timeline recorder, nullptr when tracing is off
+		sw::TraceWriter* tracer{nullptr};
+		// damage of the action being executed, reused between actions
+		DamageBatch damageBatch;
+		// placed units keep it up to date themselves on every position, hp and target change
+		ZobristHash worldHash;
+		// waiting plans of the planned units, told of every unit that appears on a cell
+		PlanScheduler planScheduler;
+
+		// sharded mode only (ShardLayout.hpp): the region this controller owns and what it shares with its neighbours
+		struct ShardView
+		{
+			Region region;
+			std::vector<uint32_t> neighbours;
+			std::vector<Region> neighbourRegions;
+			std::vector<Region> ghostBoxes; // per neighbour: cells of the region it sees as ghosts
+		};
+		std::optional<ShardView> shard;
+		// read-only copies of the neighbours' border units, replaced every round; not in 'units', never act
+		std::vector<Unit> ghosts;
+		std::vector<uint8_t> ghostSources; // neighbour slot each ghost came from
+		// hits and heals on ghosts during the turn, sent to their owners afterwards
+		std::vector<GhostEffect> ghostEffects;
 
 
 		// take ownership of the provided unit and place it on the map (SPAWN)
-		void placeUnit(std::unique_ptr<Unit> unit);
+		template <typename TArchetype>
+		void placeUnit(TArchetype unit)
+		{
+			assert(isValidCoordinate(unit.getPosition()) && "MapUnitsController::placeUnit: invalid unit position");
+			if (units.contains(unit.getId()))
+			{
+				throw std::runtime_error("BattleMap::placeUnit: unit with same id already exists");
+			}
+			auto& placed = units.add(std::move(unit));
+			spatialIndex.insert(&placed);
+			placed.attachHash(&worldHash);
+			damageBatch.reserve(units.size());
+			planScheduler.unitAt(placed);
+			if constexpr (requires { placed.startPlan(*this); })
+			{
+				planScheduler.reserve(units.size());
+				placed.startPlan(*this);
+			}
+		}
 		// returns number of actions performed in this turn
 		uint32_t doTurn();
 		void handleNextRound();
 		uint32_t removeDeadUnits();
-		void printMap();
 
 		bool assignMarchCommand(uint32_t unitId, int32_t targetX, int32_t targetY);
 
+		// Sharded round steps, each message slot goes to / comes from the neighbour at that position.
+		// The controller owns the units of 'region' only, cells outside it are played by the other shards
+		void setShard(const ShardConfig& config);
+		// own units within the halo of each neighbour / replaces the ghosts with the received ones
+		void writeGhosts(std::vector<std::string>& outgoing) const;
+		void readGhosts(const std::vector<std::string>& incoming);
+		// effects on ghosts to their owners, then drops the ghosts / applies and logs effects on own units
+		void writeGhostEffects(std::vector<std::string>& outgoing);
+		void readGhostEffects(const std::vector<std::string>& incoming);
+		// own units that left the region, removed here / units that entered it
+		void writeEmigrants(std::vector<std::string>& outgoing);
+		void readImmigrants(const std::vector<std::string>& incoming);
+		// nearest free cell of the region to the cell, for an immigrant whose cell got taken meanwhile
+		[[nodiscard]] std::optional<Coordinate> findFreeCellNear(const Coordinate& c) const;
+
 	public:
-		MapUnitsController(uint32_t w, uint32_t h, sw::EventLog& eventLog, std::function<uint64_t()> getCurrentTick) :
-			width(w), height(h), eventLog_(eventLog), getCurrentTick_(std::move(getCurrentTick))
+		MapUnitsController(uint32_t w, uint32_t h, sw::EventLog& eventLog, Random& random_, std::function<uint64_t()> getCurrentTick) :
+			width(w), height(h), random(random_), eventLog_(eventLog), getCurrentTick_(std::move(getCurrentTick))
 		{
 			if (width == 0 || height == 0)
 			{
@@ -52,19 +126,54 @@ namespace sw::core
 
 		[[nodiscard]] uint32_t getWidth() const noexcept { return width; }
 		[[nodiscard]] uint32_t getHeight() const noexcept { return height; }
+		// false for cells played by another shard, always true unsharded
+		[[nodiscard]] bool ownsCell(const Coordinate& c) const noexcept { return !shard || shard->region.contains(c); }
 
 		bool isValidCoordinate(const Coordinate& c) const { return c.getX() >= 0 && c.getY() >= 0 && static_cast<uint32_t>(c.getX()) < width && static_cast<uint32_t>(c.getY()) < height; }
 		bool isOccupied(const Coordinate& c) const;
+		// the only way to change a unit position once it is placed: keeps the spatial index in sync
+		void moveUnit(Unit& unit, const Coordinate& to);
+		[[nodiscard]] size_t getChunksCount() const noexcept { return spatialIndex.getChunksCount(); }
 
 		// const void executeAction(const Action& action);
 
 		// returns units that are within the given range from the position (range_min <= unit <= range_max)
 		[[nodiscard]] std::vector<Coordinate> getCoordinatesInRange(const Coordinate& position, uint32_t range_max, uint32_t range_min = 1) const;
-		[[nodiscard]] std::vector<std::shared_ptr<Unit>> getUnitsInRange(const Coordinate& position, uint32_t range_max, uint32_t range_min = 1) const;
+		// units around the position, narrowed with the builder: queryUnits(pos).inRange(1).where(FILTER_MELEE_TARGET).any()
+		[[nodiscard]] UnitQuery queryUnits(const Coordinate& position) const { return UnitQuery(spatialIndex, random, position); }
 		[[nodiscard]] uint32_t getUnitsCount() const { return units.size(); }
+		// units on the map minus those killed this round and not removed yet
+		[[nodiscard]] uint32_t getLivingUnitsCount() const;
+
+		// calls fn(const Unit&) for every own unit in id order, dead ones not removed yet included
+		template <typename TFunc>
+		void forEachUnit(TFunc&& fn) const
+		{
+			units.forEachUnit(fn);
+		}
+		// calls fn(const Unit&) for every unit inside the inclusive box, visiting only the chunks that overlap it
+		template <typename TFunc>
+		void forEachUnitInBox(const Coordinate& from, const Coordinate& to, TFunc&& fn) const
+		{
+			spatialIndex.forEachInBox(from.getX(), from.getY(), to.getX(), to.getY(), LAYER_ALL, [&fn](const Unit* unit) { fn(*unit); });
+		}
+
+		// actions submit hits here and resolve them with applyDamage()
+		[[nodiscard]] DamageBatch& getDamageBatch() noexcept { return damageBatch; }
+		// planned units wait here between the turns they play
+		[[nodiscard]] PlanScheduler& getPlanScheduler() noexcept { return planScheduler; }
+		// applies the pending batch, logs UNIT_ATTACKED / UNIT_DIED; returns the number of units killed
+		uint32_t applyDamage() { return damageBatch.apply(eventLog_, getCurrentTick(), ghostEffects, spatialIndex); }
+		// restores hp up to the spawn hp and logs UNIT_HEALED; a ghost target only gets the local change, its owner
+		// logs the heal
+		void heal(uint32_t healerId, Unit& target, uint32_t amount);
+
+		// 64-bit hash of every unit state on the map, equal states give equal hashes
+		[[nodiscard]] uint64_t getWorldHash() const noexcept { return worldHash.get(); }
 
 		// allow units to obtain current tick from controller (forwarded to Engine)
 		[[nodiscard]] uint64_t getCurrentTick() const { return getCurrentTick_(); }
+		[[nodiscard]] sw::TraceWriter* getTracer() const noexcept { return tracer; }
 	};
 }
 
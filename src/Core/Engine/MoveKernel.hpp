@@ -0,0 +1,212 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_MOVEKERNEL_HPP
+#define SW_BATTLE_TEST_MOVEKERNEL_HPP
+
+#include "Coordinate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sw::core
+{
+	// Step choice of a moving unit. The rule (kept from the first implementation, replays depend on it):
+	//   candidates are the free cells at Chebyshev distance 1..speed scanned dx-major, dy-minor, both ascending,
+	//   that are strictly closer (Chebyshev) to the target than the unit; the winner has the least Euclidean distance
+	//   to the target as a float (sqrtf), ties go to the first candidate in scan order.
+	// The tie rule is what std::sort gave: up to 16 elements it is an insertion sort and therefore stable, above that
+	// the order of equal keys is the introsort's own and only the sort itself reproduces it.
+	namespace move_kernel
+	{
+		// std::sort sorts this many elements or fewer with a plain (stable) insertion sort
+		inline constexpr size_t STABLE_SORT_LIMIT = 16;
+		// below this squared distance float keys are exact and sqrtf is strictly increasing on integers, so comparing
+		// integer squared distances gives the float order and the float ties
+		inline constexpr int64_t EXACT_SQUARED_DISTANCE = int64_t{1} << 22;
+
+		struct StepOffset
+		{
+			int8_t dx{0};
+			int8_t dy{0};
+		};
+		// neighbours a speed 1 unit may step to for one direction class, best first
+		struct StepPreference
+		{
+			std::array<StepOffset, 3> steps{};
+			uint8_t count{0};
+		};
+
+		constexpr int32_t sign(int32_t v) noexcept { return (v > 0) - (v < 0); }
+		constexpr int32_t absolute(int32_t v) noexcept { return v < 0 ? -v : v; }
+		constexpr int32_t chebyshev(int32_t dx, int32_t dy) noexcept { return std::max(absolute(dx), absolute(dy)); }
+
+		// class of the vector to the target: its signs and which axis is longer, 3 * 3 * 3 classes
+		constexpr size_t directionClass(int32_t dx, int32_t dy) noexcept
+		{
+			const int32_t major = sign(absolute(dx) - absolute(dy));
+			return static_cast<size_t>((sign(dx) + 1) * 9 + (sign(dy) + 1) * 3 + (major + 1));
+		}
+
+		// Within a class the order of the neighbours by squared distance only depends on the signs: for a target
+		// along x (|dx| > |dy|) the step keeps ox = sign(dx) and prefers oy = sign(dy), then 0, then -sign(dy);
+		// a target on the diagonal has the diagonal step only. So one representative vector per class gives the order
+		// for all of them. Near the edges of a class (|dy| = |dx| - 1, or an adjacent target) fewer steps are strictly
+		// closer, those are dropped at run time and the order of the others stays.
+		constexpr std::array<StepPreference, 27> makeStepPreferences() noexcept
+		{
+			std::array<StepPreference, 27> table{};
+			for (int32_t sx = -1; sx <= 1; ++sx)
+			{
+				for (int32_t sy = -1; sy <= 1; ++sy)
+				{
+					for (int32_t major = -1; major <= 1; ++major)
+					{
+						const int32_t dx = sx * (major >= 0 ? 4 : 2);
+						const int32_t dy = sy * (major <= 0 ? 4 : 2);
+						const size_t index = static_cast<size_t>((sx + 1) * 9 + (sy + 1) * 3 + (major + 1));
+						if ((dx == 0 && dy == 0) || directionClass(dx, dy) != index)
+						{
+							continue; // no vector has this class
+						}
+						StepPreference& preference = table[index];
+						std::array<int32_t, 3> keys{};
+						for (int32_t ox = -1; ox <= 1; ++ox)
+						{
+							for (int32_t oy = -1; oy <= 1; ++oy)
+							{
+								if ((ox == 0 && oy == 0) || chebyshev(dx - ox, dy - oy) >= chebyshev(dx, dy))
+								{
+									continue;
+								}
+								const int32_t key = (dx - ox) * (dx - ox) + (dy - oy) * (dy - oy);
+								// insertion keeps scan order among equal keys
+								uint8_t at = preference.count;
+								while (at > 0 && key < keys[at - 1])
+								{
+									keys[at] = keys[at - 1];
+									preference.steps[at] = preference.steps[at - 1];
+									--at;
+								}
+								keys[at] = key;
+								preference.steps[at] = StepOffset{static_cast<int8_t>(ox), static_cast<int8_t>(oy)};
+								++preference.count;
+							}
+						}
+					}
+				}
+			}
+			return table;
+		}
+		inline constexpr std::array<StepPreference, 27> STEP_PREFERENCES = makeStepPreferences();
+
+		// step of a speed 1 unit from the direction table, integer arithmetic only; the vector to the target must be
+		// short enough for exact keys (see EXACT_SQUARED_DISTANCE)
+		template <typename TFree>
+		std::optional<Coordinate> chooseNeighbour(const Coordinate& position, const Coordinate& target, TFree&& isFree)
+		{
+			const int32_t dx = target.getX() - position.getX();
+			const int32_t dy = target.getY() - position.getY();
+			const int32_t distance = chebyshev(dx, dy);
+			const StepPreference& preference = STEP_PREFERENCES[directionClass(dx, dy)];
+			for (uint8_t i = 0; i < preference.count; ++i)
+			{
+				const StepOffset step = preference.steps[i];
+				if (chebyshev(dx - step.dx, dy - step.dy) >= distance)
+				{
+					continue;
+				}
+				const Coordinate to(position.getX() + step.dx, position.getY() + step.dy);
+				if (isFree(to))
+				{
+					return to;
+				}
+			}
+			return std::nullopt;
+		}
+
+		// any speed: one scan keeping the first least key. TKey is the integer squared distance when exact, the
+		// original float distance otherwise. Returns the pick and the number of candidates seen.
+		template <typename TKey, typename TKeyOf, typename TFree>
+		std::pair<std::optional<Coordinate>, size_t> scanSteps(const Coordinate& position, const Coordinate& target, int32_t speed, TKeyOf&& keyOf, TFree&& isFree)
+		{
+			std::optional<Coordinate> best;
+			TKey bestKey{};
+			size_t candidates = 0;
+			const int32_t distance = position.chebyshevDistance(target);
+			for (int32_t dx = -speed; dx <= speed; ++dx)
+			{
+				for (int32_t dy = -speed; dy <= speed; ++dy)
+				{
+					if (dx == 0 && dy == 0)
+					{
+						continue;
+					}
+					const Coordinate to(position.getX() + dx, position.getY() + dy);
+					if (to.chebyshevDistance(target) >= distance || !isFree(to))
+					{
+						continue;
+					}
+					++candidates;
+					const TKey key = keyOf(to);
+					if (!best || key < bestKey)
+					{
+						best = to;
+						bestKey = key;
+					}
+				}
+			}
+			return {best, candidates};
+		}
+
+		// isFree(Coordinate) tells if the unit may stand there: on the map and not blocked for it
+		template <typename TFree>
+		std::optional<Coordinate> chooseStep(const Coordinate& position, const Coordinate& target, uint32_t speed, TFree&& isFree)
+		{
+			const int64_t reach = static_cast<int64_t>(position.chebyshevDistance(target)) + speed;
+			const bool exact = reach * reach * 2 < EXACT_SQUARED_DISTANCE;
+			const int32_t range = static_cast<int32_t>(speed);
+			if (exact && speed == 1)
+			{
+				return chooseNeighbour(position, target, isFree);
+			}
+			std::pair<std::optional<Coordinate>, size_t> picked;
+			if (exact)
+			{
+				picked = scanSteps<int64_t>(position, target, range, [&target](const Coordinate& c)
+				{
+					const int64_t dx = c.getX() - target.getX();
+					const int64_t dy = c.getY() - target.getY();
+					return dx * dx + dy * dy;
+				}, isFree);
+			}
+			else
+			{
+				picked = scanSteps<float>(position, target, range, [&target](const Coordinate& c) { return target.euclideanDistance(c); }, isFree);
+			}
+			if (picked.second <= STABLE_SORT_LIMIT)
+			{
+				return picked.first;
+			}
+
+			// many candidates (speed 3 and more): equal keys keep the order std::sort leaves them in, the scan collects
+			// the candidates in scan order and the sort runs on them as it always did
+			std::vector<std::pair<Coordinate, float>> options;
+			options.reserve(picked.second);
+			scanSteps<float>(position, target, range, [&options, &target](const Coordinate& c)
+			{
+				options.emplace_back(c, target.euclideanDistance(c));
+				return options.back().second;
+			}, isFree);
+			std::sort(options.begin(), options.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+			return options.front().first;
+		}
+	}
+}
+
+#endif	//SW_BATTLE_TEST_MOVEKERNEL_HPP
@@ -0,0 +1,104 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "PlanScheduler.hpp"
+
+#include <cassert>
+
+namespace sw::core
+{
+	void PlanScheduler::sleepUntil(PlanSleep& sleep, uint64_t round)
+	{
+		assert(!sleep.waiting() && "PlanScheduler::sleepUntil: plan is already waiting");
+		sleep.state = PlanSleep::State::Timer;
+		sleep.wakeRound = round;
+	}
+
+	void PlanScheduler::watch(PlanSleep& sleep, const Coordinate& position, uint32_t team, const PlanWatch& watch)
+	{
+		assert(!sleep.waiting() && "PlanScheduler::watch: plan is already waiting");
+		sleep.state = PlanSleep::State::Watch;
+		sleep.position = position;
+		sleep.team = team;
+		sleep.watch = watch;
+		reach = std::max(reach, watch.range);
+		const uint64_t key = areaOf(position);
+		auto area = findArea(key);
+		if (area == areas.end() || area->key != key)
+		{
+			assert(areas.size() < areas.capacity() && "PlanScheduler::watch: not reserved for the planned units");
+			area = areas.insert(area, Area{key, nullptr});
+		}
+		sleep.prev = nullptr;
+		sleep.next = area->watches;
+		if (sleep.next)
+		{
+			sleep.next->prev = &sleep;
+		}
+		area->watches = &sleep;
+	}
+
+	void PlanScheduler::wake(PlanSleep& sleep)
+	{
+		const PlanSleep::State state = sleep.state;
+		sleep.state = PlanSleep::State::Awake;
+		if (state != PlanSleep::State::Watch)
+		{
+			return;
+		}
+		if (sleep.next)
+		{
+			sleep.next->prev = sleep.prev;
+		}
+		if (sleep.prev)
+		{
+			sleep.prev->next = sleep.next;
+		}
+		else
+		{
+			// the head of its area, an emptied area goes
+			const auto area = findArea(areaOf(sleep.position));
+			assert(area != areas.end() && area->watches == &sleep && "PlanScheduler::wake: watch is not listed");
+			area->watches = sleep.next;
+			if (!area->watches)
+			{
+				areas.erase(area);
+			}
+		}
+		sleep.prev = nullptr;
+		sleep.next = nullptr;
+	}
+
+	void PlanScheduler::notify(const Unit& unit)
+	{
+		const Coordinate& position = unit.getPosition();
+		const auto r = static_cast<int32_t>(reach);
+		const auto layer = layerBit(unit.getLayer());
+		for (int32_t x = (position.getX() - r) >> CHUNK_SIZE_LOG2; x <= (position.getX() + r) >> CHUNK_SIZE_LOG2; ++x)
+		{
+			for (int32_t y = (position.getY() - r) >> CHUNK_SIZE_LOG2; y <= (position.getY() + r) >> CHUNK_SIZE_LOG2; ++y)
+			{
+				const uint64_t key = areaKey(x, y);
+				const auto area = findArea(key);
+				if (area == areas.end() || area->key != key)
+				{
+					continue;
+				}
+				// the same test as the query a plan runs before it starts waiting; waking unlinks, the next is kept
+				for (PlanSleep* sleep = area->watches; sleep;)
+				{
+					PlanSleep* next = sleep->next;
+					const int32_t distance = sleep->position.distance(position);
+					const bool enemy = sleep->team == NO_TEAM || unit.getTeam() != sleep->team;
+					if (enemy && distance >= 1 && static_cast<uint32_t>(distance) <= sleep->watch.range &&
+						(sleep->watch.layers & layer) && unit.hasFlags(sleep->watch.requiredFlags))
+					{
+						wake(*sleep);
+					}
+					sleep = next;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_PLANSCHEDULER_HPP
+#define SW_BATTLE_TEST_PLANSCHEDULER_HPP
+
+#include "Core/Units/UnitPlan.hpp"
+#include "SpatialIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sw::core
+{
+	// A plan as the scheduler holds it, one per planned unit
+	struct PlanSleep
+	{
+		enum class State : uint8_t
+		{
+			Awake,
+			Timer, // until wakeRound, the unit checks it on its turn
+			Watch // linked into the watch list of its area
+		};
+		State state{State::Awake};
+		uint64_t wakeRound{0};
+		Coordinate position;
+		uint32_t team{NO_TEAM};
+		PlanWatch watch;
+		PlanSleep* prev{nullptr};
+		PlanSleep* next{nullptr};
+
+		[[nodiscard]] bool waiting() const noexcept { return state != State::Awake; }
+		// wakes a plan whose timer is due at the round, true while it still waits
+		[[nodiscard]] bool waitingAt(uint64_t round) noexcept
+		{
+			if (state == State::Timer && wakeRound <= round)
+			{
+				state = State::Awake;
+			}
+			return waiting();
+		}
+	};
+
+	// Resumption queue of unit plans (UnitPlan.hpp). A waiting plan is off the turn: its unit passes without
+	// evaluating anything until it is woken - its timer is due, or an enemy it watches for appears in range (spawned,
+	// moved or arrived as a ghost). Units are woken in the turn order they would have noticed it themselves: a unit
+	// woken before its turn plays in the same round. Watches are linked into their plans, a scheduler reserved for
+	// the planned units never allocates.
+	class PlanScheduler
+	{
+		struct Area
+		{
+			uint64_t key; // spatial index chunk
+			PlanSleep* watches; // list through PlanSleep::next
+		};
+		// areas having watches, sorted by key. A watch is listed in the area of its position only, a unit appearing
+		// looks at every area the longest watch reaches from it
+		std::vector<Area> areas;
+		uint32_t reach{0};
+
+		static uint64_t areaKey(int32_t x, int32_t y) noexcept
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+		}
+		static uint64_t areaOf(const Coordinate& position) noexcept
+		{
+			return areaKey(position.getX() >> CHUNK_SIZE_LOG2, position.getY() >> CHUNK_SIZE_LOG2);
+		}
+		std::vector<Area>::iterator findArea(uint64_t key) noexcept
+		{
+			return std::lower_bound(areas.begin(), areas.end(), key, [](const Area& a, uint64_t k) { return a.key < k; });
+		}
+		void notify(const Unit& unit);
+
+	public:
+		// room for the watches of this many plans, called when a planned unit is placed
+		void reserve(size_t plans)
+		{
+			if (areas.capacity() < plans)
+			{
+				areas.reserve(std::max(plans, areas.capacity() * 2));
+			}
+		}
+
+		// the plan plays again on its turn of the round
+		static void sleepUntil(PlanSleep& sleep, uint64_t round);
+		// the plan plays again once an enemy of the team matching the watch is within range of the position
+		void watch(PlanSleep& sleep, const Coordinate& position, uint32_t team, const PlanWatch& watch);
+		// the plan stops waiting (a new order, its unit leaves the map); nothing if it does not wait
+		void wake(PlanSleep& sleep);
+
+		// a unit appeared on its cell, wakes the plans watching for it; free while nobody watches
+		void unitAt(const Unit& unit)
+		{
+			if (!areas.empty())
+			{
+				notify(unit);
+			}
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_PLANSCHEDULER_HPP
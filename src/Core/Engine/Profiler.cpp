@@ -0,0 +1,152 @@
+//
+// Created by Carpov Pavel on 19.10.2025.
+//
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace sw::core
+{
+	uint64_t ProfileEntry::quantileTicks(double q) const noexcept
+	{
+		if (calls == 0)
+		{
+			return 0;
+		}
+		const auto rank = static_cast<uint64_t>(q * static_cast<double>(calls - 1)) + 1;
+		uint64_t seen = 0;
+		for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+		{
+			seen += histogram[bucket];
+			if (seen >= rank)
+			{
+				// clamp the bucket bound to the observed maximum
+				uint64_t upper = bucket + 1 < 64 ? (uint64_t{1} << (bucket + 1)) - 1 : UINT64_MAX;
+				return std::min(upper, maxTicks);
+			}
+		}
+		return maxTicks;
+	}
+
+	void Profiler::start()
+	{
+		enabled = true;
+		startTime = std::chrono::steady_clock::now();
+		startTicks = readTimestamp();
+	}
+
+	void Profiler::stop()
+	{
+		stopTicks = readTimestamp();
+		stopTime = std::chrono::steady_clock::now();
+		enabled = false;
+	}
+
+	ProfileEntry& Profiler::getEntry(const char* name)
+	{
+		// call sites resolve their entry on first use, possibly from several engine threads at once
+		std::lock_guard lock(entriesMutex);
+		for (auto& entry : entries)
+		{
+			if (std::strcmp(entry.name.c_str(), name) == 0)
+			{
+				return entry;
+			}
+		}
+		auto& entry = entries.emplace_back();
+		entry.name = name;
+		return entry;
+	}
+
+	double Profiler::ticksPerNs() const noexcept
+	{
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stopTime - startTime).count();
+		if (ns <= 0 || stopTicks <= startTicks)
+		{
+			return 1.0;
+		}
+		return static_cast<double>(stopTicks - startTicks) / static_cast<double>(ns);
+	}
+
+	void Profiler::printSummary(std::ostream& stream) const
+	{
+		const double tpn = ticksPerNs();
+		const auto toNs = [tpn](uint64_t ticks) { return static_cast<double>(ticks) / tpn; };
+
+		std::vector<const ProfileEntry*> sorted;
+		for (const auto& entry : entries)
+		{
+			if (entry.calls)
+			{
+				sorted.push_back(&entry);
+			}
+		}
+		std::sort(sorted.begin(), sorted.end(), [](auto a, auto b) { return a->totalTicks > b->totalTicks; });
+
+		stream << "Profile (inclusive times, " << std::fixed << std::setprecision(2) << tpn << " ticks/ns):\n";
+		stream << std::left << std::setw(44) << "section" << std::right << std::setw(12) << "calls" << std::setw(12)
+			   << "ok" << std::setw(12) << "fail" << std::setw(12) << "total ms" << std::setw(12) << "mean ns"
+			   << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << std::setw(12) << "max ns" << '\n';
+		for (const auto* entry : sorted)
+		{
+			const bool hasResults = entry->successes + entry->failures > 0;
+			stream << std::left << std::setw(44) << entry->name << std::right << std::setw(12) << entry->calls;
+			if (hasResults)
+			{
+				stream << std::setw(12) << entry->successes << std::setw(12) << entry->failures;
+			}
+			else
+			{
+				stream << std::setw(12) << "-" << std::setw(12) << "-";
+			}
+			stream << std::setprecision(3) << std::setw(12) << toNs(entry->totalTicks) / 1e6 << std::setprecision(0)
+				   << std::setw(12) << toNs(entry->totalTicks) / static_cast<double>(entry->calls) << std::setw(12)
+				   << toNs(entry->quantileTicks(0.5)) << std::setw(12) << toNs(entry->quantileTicks(0.99))
+				   << std::setw(12) << toNs(entry->maxTicks) << '\n';
+		}
+		stream.unsetf(std::ios::floatfield);
+	}
+
+	void Profiler::writeJson(std::ostream& stream) const
+	{
+		const double tpn = ticksPerNs();
+		const auto toNs = [tpn](uint64_t ticks) { return static_cast<uint64_t>(static_cast<double>(ticks) / tpn); };
+		const auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(stopTime - startTime).count();
+
+		stream << "{\n  \"ticksPerNs\": " << tpn << ",\n  \"wallNs\": " << wallNs << ",\n  \"sections\": [";
+		bool first = true;
+		for (const auto& entry : entries)
+		{
+			if (!entry.calls)
+			{
+				continue;
+			}
+			stream << (first ? "\n" : ",\n");
+			first = false;
+			stream << "    {\"name\": \"" << entry.name << "\", \"calls\": " << entry.calls
+				   << ", \"successes\": " << entry.successes << ", \"failures\": " << entry.failures
+				   << ", \"totalNs\": " << toNs(entry.totalTicks) << ", \"minNs\": " << toNs(entry.minTicks)
+				   << ", \"maxNs\": " << toNs(entry.maxTicks) << ", \"p50Ns\": " << toNs(entry.quantileTicks(0.5))
+				   << ", \"p99Ns\": " << toNs(entry.quantileTicks(0.99)) << ", \"histogram\": [";
+			// only non-empty buckets, as [upper bound ns, count]
+			bool firstBucket = true;
+			for (size_t bucket = 0; bucket < entry.histogram.size(); ++bucket)
+			{
+				if (!entry.histogram[bucket])
+				{
+					continue;
+				}
+				uint64_t upper = bucket + 1 < 64 ? (uint64_t{1} << (bucket + 1)) - 1 : UINT64_MAX;
+				stream << (firstBucket ? "" : ", ") << "[" << toNs(upper) << ", " << entry.histogram[bucket] << "]";
+				firstBucket = false;
+			}
+			stream << "]}";
+		}
+		stream << "\n  ]\n}\n";
+	}
+}
@@ -0,0 +1,193 @@
+//
+// Created by Carpov Pavel on 19.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_PROFILER_HPP
+#define SW_BATTLE_TEST_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// SW_PROFILER is set by CMake (option SW_ENABLE_PROFILER). When it is 0 every SW_PROFILE_* macro expands to nothing.
+#ifndef SW_PROFILER
+#define SW_PROFILER 0
+#endif
+
+namespace sw::core
+{
+	// raw timestamp counter, falls back to steady_clock ticks where no TSC-like counter is available
+	inline uint64_t readTimestamp() noexcept
+	{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#elif defined(__aarch64__)
+		uint64_t value;
+		asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+		return value;
+#else
+		return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	inline constexpr size_t PROFILE_HISTOGRAM_BUCKETS = 64;
+
+	// counters of one instrumented section (phase or action type), latency is kept in log2 buckets of timestamp ticks
+	struct ProfileEntry
+	{
+		std::string name;
+		uint64_t calls{0};
+		uint64_t successes{0};
+		uint64_t failures{0};
+		uint64_t totalTicks{0};
+		uint64_t minTicks{UINT64_MAX};
+		uint64_t maxTicks{0};
+		std::array<uint64_t, PROFILE_HISTOGRAM_BUCKETS> histogram{};
+
+		void record(uint64_t ticks) noexcept
+		{
+			++calls;
+			totalTicks += ticks;
+			minTicks = ticks < minTicks ? ticks : minTicks;
+			maxTicks = ticks > maxTicks ? ticks : maxTicks;
+			++histogram[bucketOf(ticks)];
+		}
+
+		// bucket i holds samples in [2^i, 2^(i+1))
+		static size_t bucketOf(uint64_t ticks) noexcept
+		{
+			return ticks ? static_cast<size_t>(std::bit_width(ticks)) - 1 : 0;
+		}
+
+		// upper bound (in ticks) of the bucket containing the given quantile
+		[[nodiscard]] uint64_t quantileTicks(double q) const noexcept;
+	};
+
+	// Process-wide collector of section timings. Recording is a no-op until start() is called.
+	class Profiler
+	{
+		std::deque<ProfileEntry> entries; // deque keeps references stable for cached entries
+		std::mutex entriesMutex;
+		bool enabled{false};
+		uint64_t startTicks{0};
+		uint64_t stopTicks{0};
+		std::chrono::steady_clock::time_point startTime{};
+		std::chrono::steady_clock::time_point stopTime{};
+
+		Profiler() = default;
+
+	public:
+		static Profiler& getInstance()
+		{
+			static Profiler instance;
+			return instance;
+		}
+
+		[[nodiscard]] bool isEnabled() const noexcept { return enabled; }
+		void start();
+		void stop();
+
+		// finds or creates the entry with the given name; linear, meant to be cached by the call site
+		ProfileEntry& getEntry(const char* name);
+
+		// timestamp ticks per nanosecond, calibrated against steady_clock over the profiled interval
+		[[nodiscard]] double ticksPerNs() const noexcept;
+
+		void printSummary(std::ostream& stream) const;
+		void writeJson(std::ostream& stream) const;
+	};
+
+	// call site of a fixed section: constant-initialized, its entry is looked up on the first profiled pass, so call
+	// sites reached with the profiler stopped never allocate
+	struct ProfileSite
+	{
+		const char* name;
+		std::atomic<ProfileEntry*> entry{nullptr};
+	};
+
+	// RAII timer of one section, optionally marked as success or failure
+	class ProfileScope
+	{
+		ProfileEntry* entry{nullptr};
+		uint64_t begin{0};
+		int8_t result{-1};
+
+	public:
+		explicit ProfileScope(ProfileSite& site)
+		{
+			if (Profiler::getInstance().isEnabled())
+			{
+				entry = site.entry.load(std::memory_order_acquire);
+				if (!entry)
+				{
+					// getEntry returns the same entry to every thread, racing stores write the same pointer
+					entry = &Profiler::getInstance().getEntry(site.name);
+					site.entry.store(entry, std::memory_order_release);
+				}
+				begin = readTimestamp();
+			}
+		}
+		// resolves the entry by name only when profiling is running
+		explicit ProfileScope(const char* name)
+		{
+			if (Profiler::getInstance().isEnabled())
+			{
+				entry = &Profiler::getInstance().getEntry(name);
+				begin = readTimestamp();
+			}
+		}
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+		void setResult(bool success) noexcept { result = success ? 1 : 0; }
+
+		~ProfileScope()
+		{
+			if (!entry)
+			{
+				return;
+			}
+			entry->record(readTimestamp() - begin);
+			if (result == 1)
+			{
+				++entry->successes;
+			}
+			else if (result == 0)
+			{
+				++entry->failures;
+			}
+		}
+	};
+}
+
+#define SW_PROFILE_CAT_IMPL(a, b) a##b
+#define SW_PROFILE_CAT(a, b) SW_PROFILE_CAT_IMPL(a, b)
+
+#if SW_PROFILER
+// times the rest of the enclosing block under a fixed section name
+#define SW_PROFILE_SCOPE(name)                                                                                      \
+	static constinit ::sw::core::ProfileSite SW_PROFILE_CAT(swProfileSite, __LINE__){name};                       \
+	::sw::core::ProfileScope SW_PROFILE_CAT(swProfileScope, __LINE__)(SW_PROFILE_CAT(swProfileSite, __LINE__))
+// named scope for sections resolved at runtime (e.g. per action type), result is reported via SW_PROFILE_RESULT
+#define SW_PROFILE_NAMED_SCOPE(var, name)                                                                           \
+	::sw::core::ProfileScope var(static_cast<const char*>(name))
+#define SW_PROFILE_RESULT(var, success) var.setResult(success)
+#else
+#define SW_PROFILE_SCOPE(name)
+#define SW_PROFILE_NAMED_SCOPE(var, name)
+#define SW_PROFILE_RESULT(var, success)
+#endif
+
+#endif	//SW_BATTLE_TEST_PROFILER_HPP
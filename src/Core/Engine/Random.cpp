@@ -0,0 +1,64 @@
+//
+// Created by Carpov Pavel on 26.09.2025.
+//
+
+#include "Random.hpp"
+
+#include "ZobristHash.hpp"
+
+#include <random>
+
+namespace sw::core
+{
+	namespace
+	{
+		uint64_t rotl(uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+	}
+
+	Random::Random()
+	{
+		std::random_device device;
+		reseed(static_cast<uint64_t>(device()) << 32 | device());
+	}
+
+	void Random::reseed(uint64_t seed) noexcept
+	{
+		// the state words are a splitmix64 sequence, never all zero
+		for (auto& word : s)
+		{
+			seed += 0x9e3779b97f4a7c15ULL;
+			word = mixBits(seed);
+		}
+		draws = 0;
+	}
+
+	uint64_t Random::next() noexcept
+	{
+		++draws;
+		const uint64_t result = rotl(s[1] * 5, 7) * 9;
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	uint32_t Random::inRange(uint32_t max, uint32_t min)
+	{
+		std::uniform_int_distribution<uint32_t> distrib(min, max);
+		return distrib(*this);
+	}
+
+	uint64_t Random::getStateHash() const noexcept
+	{
+		uint64_t h = 0;
+		for (const auto word : s)
+		{
+			h = mixBits(h ^ word);
+		}
+		return h;
+	}
+}
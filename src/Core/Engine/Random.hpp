@@ -0,0 +1,42 @@
+//
+// Created by Carpov Pavel on 26.09.2025.
+//
+
+#ifndef SW_BATTLE_TEST_RANDOM_HPP
+#define SW_BATTLE_TEST_RANDOM_HPP
+#include <cstdint>
+
+namespace sw::core
+{
+	// Random numbers of one engine. xoshiro256**: small state, so it can be seeded, fingerprinted and compared
+	// cheaply. Engines never share a generator, runs started with the same seed draw the same numbers
+	class Random
+	{
+		uint64_t s[4]{};
+		uint64_t draws{0};
+
+		uint64_t next() noexcept;
+
+	public:
+		// seeded from std::random_device
+		Random();
+		explicit Random(uint64_t seed) noexcept { reseed(seed); }
+
+		void reseed(uint64_t seed) noexcept;
+		// uniform in [min, max]
+		uint32_t inRange(uint32_t max, uint32_t min = 0);
+
+		// fingerprint of the state: equal fingerprints draw equal sequences
+		[[nodiscard]] uint64_t getStateHash() const noexcept;
+		// numbers drawn so far
+		[[nodiscard]] uint64_t getDrawCount() const noexcept { return draws; }
+
+		// UniformRandomBitGenerator, for the <random> distributions
+		using result_type = uint64_t;
+		static constexpr result_type min() noexcept { return 0; }
+		static constexpr result_type max() noexcept { return UINT64_MAX; }
+		result_type operator()() noexcept { return next(); }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_RANDOM_HPP
@@ -0,0 +1,90 @@
+//
+// Created by Carpov Pavel on 26.10.2025.
+//
+
+#include "Scenario.hpp"
+
+#include "Engine.hpp"
+#include "Core/Units/UnitDefinitions.hpp"
+#include "IO/Commands/CreateMap.hpp"
+#include "IO/Commands/March.hpp"
+#include "IO/Commands/SpawnHealer.hpp"
+#include "IO/Commands/SpawnHunter.hpp"
+#include "IO/Commands/SpawnMine.hpp"
+#include "IO/Commands/SpawnSwordsman.hpp"
+#include "IO/Commands/SpawnUnit.hpp"
+#include "IO/System/CommandParser.hpp"
+#include "IO/System/PrintDebug.hpp"
+
+namespace sw::core
+{
+	namespace
+	{
+		template <class... TCommands>
+		void addCommands(io::CommandParser& parser, std::vector<std::function<void(Engine&)>>& commands, std::ostream* echo)
+		{
+			(parser.add<TCommands>([&commands, echo](TCommands command)
+			{
+				if (echo)
+				{
+					printDebug(*echo, command);
+				}
+				commands.push_back([c = std::move(command)](Engine& engine) { engine.handleCommand(c); });
+			}), ...);
+		}
+
+		void addUnitKinds(io::CommandParser& parser, std::vector<std::function<void(Engine&)>>& commands, std::ostream* echo,
+			const UnitDefinitions& units)
+		{
+			for (const auto& definition : units.getAll())
+			{
+				parser.add<io::SpawnUnit>(definition.makeSpawnPrototype(), [&commands, echo, &definition](io::SpawnUnit command)
+				{
+					if (echo)
+					{
+						printDebug(*echo, command);
+					}
+					commands.push_back([c = std::move(command), &definition](Engine& engine) { engine.handleCommand(c, definition); });
+				});
+			}
+		}
+
+		template <typename TParse>
+		void parseWith(std::vector<std::function<void(Engine&)>>& commands, std::ostream* echo,
+			const UnitDefinitions* units, TParse&& parse)
+		{
+			io::CommandParser parser;
+			addCommands<io::CreateMap, io::SpawnSwordsman, io::SpawnHunter, io::SpawnMine, io::SpawnHealer, io::March>(
+				parser, commands, echo);
+			if (units)
+			{
+				addUnitKinds(parser, commands, echo, *units);
+			}
+			parse(parser);
+		}
+	}
+
+	Scenario Scenario::parse(std::istream& in, std::ostream* echo, std::shared_ptr<const UnitDefinitions> units)
+	{
+		Scenario scenario;
+		scenario.units = std::move(units);
+		parseWith(scenario.commands, echo, scenario.units.get(), [&in](io::CommandParser& parser) { parser.parse(in); });
+		return scenario;
+	}
+
+	Scenario Scenario::parseBinary(std::istream& in, std::shared_ptr<const UnitDefinitions> units)
+	{
+		Scenario scenario;
+		scenario.units = std::move(units);
+		parseWith(scenario.commands, nullptr, scenario.units.get(), [&in](io::CommandParser& parser) { parser.parseBinary(in); });
+		return scenario;
+	}
+
+	void Scenario::applyTo(Engine& engine) const
+	{
+		for (const auto& command : commands)
+		{
+			command(engine);
+		}
+	}
+}
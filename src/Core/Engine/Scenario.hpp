@@ -0,0 +1,37 @@
+//
+// Created by Carpov Pavel on 26.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SCENARIO_HPP
+#define SW_BATTLE_TEST_SCENARIO_HPP
+
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+namespace sw::core
+{
+	class Engine;
+	class UnitDefinitions;
+
+	// Parsed scenario commands, replayable into any number of engines
+	class Scenario
+	{
+		std::vector<std::function<void(Engine&)>> commands;
+		// spawns of defined kinds point into it
+		std::shared_ptr<const UnitDefinitions> units;
+
+	public:
+		// text commands, each parsed command is also printed to 'echo' when given. Every kind of 'units' adds its
+		// SPAWN_<KIND> command
+		static Scenario parse(std::istream& in, std::ostream* echo = nullptr, std::shared_ptr<const UnitDefinitions> units = nullptr);
+		// records written by BinaryCommandWriterVisitor
+		static Scenario parseBinary(std::istream& in, std::shared_ptr<const UnitDefinitions> units = nullptr);
+
+		void applyTo(Engine& engine) const;
+		[[nodiscard]] size_t getCommandsCount() const noexcept { return commands.size(); }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SCENARIO_HPP
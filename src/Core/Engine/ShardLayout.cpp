@@ -0,0 +1,117 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "ShardLayout.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sw::core
+{
+	Region Region::grown(uint32_t cells) const noexcept
+	{
+		const auto grow = static_cast<int64_t>(cells);
+		return Region{static_cast<int32_t>(std::max<int64_t>(INT32_MIN, minX - grow)),
+			static_cast<int32_t>(std::max<int64_t>(INT32_MIN, minY - grow)),
+			static_cast<int32_t>(std::min<int64_t>(INT32_MAX, maxX + grow)),
+			static_cast<int32_t>(std::min<int64_t>(INT32_MAX, maxY + grow))};
+	}
+
+	Region Region::intersect(const Region& other) const noexcept
+	{
+		return Region{std::max(minX, other.minX), std::max(minY, other.minY), std::min(maxX, other.maxX), std::min(maxY, other.maxY)};
+	}
+
+	int32_t ShardLayout::bandStart(uint32_t band, uint32_t bands, uint32_t size) noexcept
+	{
+		return static_cast<int32_t>(static_cast<uint64_t>(band) * size / bands);
+	}
+
+	uint32_t ShardLayout::bandOf(int32_t cell, uint32_t bands, uint32_t size) noexcept
+	{
+		auto band = static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(cell) * bands / size, 0, bands - 1));
+		while (band + 1 < bands && bandStart(band + 1, bands, size) <= cell)
+		{
+			++band;
+		}
+		while (band > 0 && bandStart(band, bands, size) > cell)
+		{
+			--band;
+		}
+		return band;
+	}
+
+	ShardLayout::ShardLayout(const ShardConfig& config, uint32_t width_, uint32_t height_) :
+		columns(config.columns), rows(config.rows), width(width_), height(height_)
+	{
+		if (columns == 0 || rows == 0)
+		{
+			throw std::runtime_error("Shards: the grid needs at least one column and one row");
+		}
+		// the narrowest band is size / bands cells wide (rounded down)
+		if (width / columns < config.halo || height / rows < config.halo)
+		{
+			throw std::runtime_error("Shards: regions of a " + std::to_string(columns) + "x" + std::to_string(rows) +
+				" grid on a " + std::to_string(width) + "x" + std::to_string(height) + " map are narrower than the halo of " +
+				std::to_string(config.halo) + " cells");
+		}
+	}
+
+	Region ShardLayout::getRegion(uint32_t shard) const noexcept
+	{
+		const uint32_t column = shard % columns;
+		const uint32_t row = shard / columns;
+		return Region{bandStart(column, columns, width), bandStart(row, rows, height),
+			bandStart(column + 1, columns, width) - 1, bandStart(row + 1, rows, height) - 1};
+	}
+
+	uint32_t ShardLayout::shardAt(const Coordinate& c) const noexcept
+	{
+		return bandOf(c.getY(), rows, height) * columns + bandOf(c.getX(), columns, width);
+	}
+
+	std::vector<uint32_t> ShardLayout::neighboursOf(uint32_t columns, uint32_t rows, uint32_t shard)
+	{
+		std::vector<uint32_t> neighbours;
+		const auto column = static_cast<int64_t>(shard % columns);
+		const auto row = static_cast<int64_t>(shard / columns);
+		// row-major scan gives ascending indices
+		for (int64_t r = row - 1; r <= row + 1; ++r)
+		{
+			for (int64_t c = column - 1; c <= column + 1; ++c)
+			{
+				if ((r == row && c == column) || r < 0 || c < 0 || r >= rows || c >= columns)
+				{
+					continue;
+				}
+				neighbours.push_back(static_cast<uint32_t>(r * columns + c));
+			}
+		}
+		return neighbours;
+	}
+
+	ShardConfig parseShardGrid(const std::string& spec)
+	{
+		ShardConfig config;
+		const auto separator = spec.find('x');
+		try
+		{
+			if (separator == std::string::npos)
+			{
+				throw std::invalid_argument(spec);
+			}
+			config.columns = static_cast<uint32_t>(std::stoul(spec.substr(0, separator)));
+			config.rows = static_cast<uint32_t>(std::stoul(spec.substr(separator + 1)));
+		}
+		catch (const std::logic_error&)
+		{
+			throw std::runtime_error("Error: Bad shard grid, expected --shards=CxR - " + spec);
+		}
+		if (config.columns == 0 || config.rows == 0)
+		{
+			throw std::runtime_error("Error: Bad shard grid, expected --shards=CxR - " + spec);
+		}
+		return config;
+	}
+}
@@ -0,0 +1,77 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SHARDLAYOUT_HPP
+#define SW_BATTLE_TEST_SHARDLAYOUT_HPP
+
+#include "Coordinate.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sw::core
+{
+	inline constexpr uint32_t DEFAULT_SHARD_HALO = 8;
+
+	// Sharded mode: the map is split into columns x rows rectangular regions, each one played by its own shard.
+	// A shard owns the units standing in its region and sees the units of its neighbours within 'halo' cells of its
+	// border as ghosts, so the halo has to cover the longest reach (move, attack, heal, trigger) of any unit
+	struct ShardConfig
+	{
+		uint32_t columns{1};
+		uint32_t rows{1};
+		uint32_t index{0}; // row-major: index = row * columns + column
+		uint32_t halo{DEFAULT_SHARD_HALO};
+	};
+
+	// inclusive box of cells
+	struct Region
+	{
+		int32_t minX{0};
+		int32_t minY{0};
+		int32_t maxX{-1};
+		int32_t maxY{-1};
+
+		[[nodiscard]] bool contains(const Coordinate& c) const noexcept
+		{
+			return c.getX() >= minX && c.getX() <= maxX && c.getY() >= minY && c.getY() <= maxY;
+		}
+		[[nodiscard]] bool empty() const noexcept { return minX > maxX || minY > maxY; }
+		// the box grown by 'cells' on every side
+		[[nodiscard]] Region grown(uint32_t cells) const noexcept;
+		[[nodiscard]] Region intersect(const Region& other) const noexcept;
+	};
+
+	class ShardLayout
+	{
+		uint32_t columns;
+		uint32_t rows;
+		uint32_t width;
+		uint32_t height;
+
+		// first cell of the band: column (or row) 'band' of 'bands' over 'size' cells
+		static int32_t bandStart(uint32_t band, uint32_t bands, uint32_t size) noexcept;
+		static uint32_t bandOf(int32_t cell, uint32_t bands, uint32_t size) noexcept;
+
+	public:
+		// throws if a region would be narrower than the halo: ghosts must come from adjacent regions only
+		ShardLayout(const ShardConfig& config, uint32_t width_, uint32_t height_);
+
+		[[nodiscard]] uint32_t getShardsCount() const noexcept { return columns * rows; }
+		[[nodiscard]] Region getRegion(uint32_t shard) const noexcept;
+		// shard owning a cell of the map
+		[[nodiscard]] uint32_t shardAt(const Coordinate& c) const noexcept;
+
+		// shards around the shard (up to 8) in ascending order, the order of every exchange between neighbours.
+		// Depends on the grid only, a transport can be set up before the map size is known
+		static std::vector<uint32_t> neighboursOf(uint32_t columns, uint32_t rows, uint32_t shard);
+	};
+
+	// "CxR" (e.g. "4x2") to columns and rows, throws on anything else
+	ShardConfig parseShardGrid(const std::string& spec);
+}
+
+#endif	//SW_BATTLE_TEST_SHARDLAYOUT_HPP
@@ -0,0 +1,46 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SHARDTRANSPORT_HPP
+#define SW_BATTLE_TEST_SHARDTRANSPORT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sw::core
+{
+	// values every shard contributes to the decisions taken for the whole world
+	struct ShardTotals
+	{
+		uint64_t units{0}; // summed
+		uint64_t living{0}; // summed
+		uint64_t actions{0}; // summed
+		uint64_t worldHash{0}; // XOR: the world hash is a XOR over units, so this is the hash of the whole world
+
+		void add(const ShardTotals& other) noexcept
+		{
+			units += other.units;
+			living += other.living;
+			actions += other.actions;
+			worldHash ^= other.worldHash;
+		}
+	};
+
+	// Link of one shard engine with the other shards, provided by whatever runs them (processes, threads).
+	// Every call is a collective step: all shards make the same calls in the same order, each returns once the
+	// step is complete everywhere
+	class ShardTransport
+	{
+	public:
+		virtual ~ShardTransport() = default;
+
+		// sends outgoing[i] to the i-th neighbour (ShardLayout::neighboursOf order) and receives incoming[i] from it
+		virtual void exchange(const std::vector<std::string>& outgoing, std::vector<std::string>& incoming) = 0;
+		// totals over all shards, the same on every shard
+		virtual ShardTotals reduce(const ShardTotals& local) = 0;
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SHARDTRANSPORT_HPP
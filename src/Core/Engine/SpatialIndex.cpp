@@ -0,0 +1,149 @@
+//
+// Created by Carpov Pavel on 21.10.2025.
+//
+
+#include "SpatialIndex.hpp"
+
+#include <cassert>
+
+namespace sw::core
+{
+	namespace
+	{
+		bool idLess(const Unit* a, const Unit* b) noexcept
+		{
+			return a->getId() < b->getId();
+		}
+	}
+
+	void SpatialIndex::insertInto(Chunk& chunk, Unit* unit)
+	{
+		auto& units = chunk.layers[static_cast<size_t>(unit->getLayer())];
+		const size_t capacity = units.capacity();
+		units.insert(std::lower_bound(units.begin(), units.end(), unit, idLess), unit);
+		// the wounded list grows along with the layers, only when they do
+		if (units.capacity() != capacity)
+		{
+			size_t room = 0;
+			for (const auto& layer : chunk.layers)
+			{
+				room += layer.capacity();
+			}
+			chunk.wounded.reserve(room);
+		}
+		if (unit->isWounded())
+		{
+			chunk.wounded.insert(std::lower_bound(chunk.wounded.begin(), chunk.wounded.end(), unit, idLess), unit);
+		}
+	}
+
+	SpatialIndex::Chunks& SpatialIndex::chunksOf(uint32_t team)
+	{
+		auto it = std::lower_bound(partitions.begin(), partitions.end(), team,
+			[](const Partition& partition, uint32_t t) { return partition.team < t; });
+		if (it == partitions.end() || it->team != team)
+		{
+			it = partitions.insert(it, Partition{team, {}});
+		}
+		return it->chunks;
+	}
+
+	SpatialIndex::Chunk& SpatialIndex::chunkAt(Chunks& chunks, uint64_t key)
+	{
+		if (auto it = chunks.find(key); it != chunks.end())
+		{
+			return it->second;
+		}
+		if (spareChunks.empty())
+		{
+			// a new node: the spare list gets room for it now, so dropping chunks later does not allocate
+			++createdChunks;
+			if (spareChunks.capacity() < createdChunks)
+			{
+				spareChunks.reserve(std::max(createdChunks, spareChunks.capacity() * 2));
+			}
+			return chunks[key];
+		}
+		Chunks::node_type node = std::move(spareChunks.back());
+		spareChunks.pop_back();
+		node.key() = key;
+		return chunks.insert(std::move(node)).position->second;
+	}
+
+	void SpatialIndex::insert(Unit* unit)
+	{
+		insertInto(chunkAt(chunksOf(unit->getTeam()), keyOf(unit->getPosition())), unit);
+	}
+
+	void SpatialIndex::remove(Unit* unit)
+	{
+		Chunks& chunks = chunksOf(unit->getTeam());
+		auto it = chunks.find(keyOf(unit->getPosition()));
+		assert(it != chunks.end() && "SpatialIndex::remove: unit chunk not found");
+		auto& units = it->second.layers[static_cast<size_t>(unit->getLayer())];
+		auto pos = std::lower_bound(units.begin(), units.end(), unit, idLess);
+		assert(pos != units.end() && *pos == unit && "SpatialIndex::remove: unit not indexed");
+		units.erase(pos);
+		// by presence, not by the flag: a unit about to leave may change HP without an update (a mine exploding)
+		auto& wounded = it->second.wounded;
+		if (auto listed = std::lower_bound(wounded.begin(), wounded.end(), unit, idLess); listed != wounded.end() && *listed == unit)
+		{
+			wounded.erase(listed);
+		}
+		// empty chunks leave the index, so queries only walk the occupied area; the node is kept for reuse
+		if (it->second.empty())
+		{
+			spareChunks.push_back(chunks.extract(it));
+		}
+	}
+
+	void SpatialIndex::relocate(Unit* unit, const Coordinate& to)
+	{
+		if (keyOf(unit->getPosition()) == keyOf(to))
+		{
+			return; // same chunk, nothing to update
+		}
+		remove(unit);
+		insertInto(chunkAt(chunksOf(unit->getTeam()), keyOf(to)), unit);
+	}
+
+	void SpatialIndex::updateWounded(Unit* unit)
+	{
+		Chunks& chunks = chunksOf(unit->getTeam());
+		auto it = chunks.find(keyOf(unit->getPosition()));
+		assert(it != chunks.end() && "SpatialIndex::updateWounded: unit chunk not found");
+		auto& wounded = it->second.wounded;
+		auto pos = std::lower_bound(wounded.begin(), wounded.end(), unit, idLess);
+		const bool listed = pos != wounded.end() && *pos == unit;
+		if (unit->isWounded() && !listed)
+		{
+			assert(wounded.size() < wounded.capacity() && "SpatialIndex::updateWounded: no room kept for the chunk");
+			wounded.insert(pos, unit);
+		}
+		else if (!unit->isWounded() && listed)
+		{
+			wounded.erase(pos);
+		}
+	}
+
+	Unit* SpatialIndex::findSolidAt(const Coordinate& c) const
+	{
+		// a cell blocks whatever the team, so every partition is looked at
+		for (const Partition& partition : partitions)
+		{
+			auto it = partition.chunks.find(keyOf(c));
+			if (it == partition.chunks.end())
+			{
+				continue;
+			}
+			for (Unit* unit : it->second.layers[static_cast<size_t>(UnitLayer::Ground)])
+			{
+				if (unit->getPosition() == c)
+				{
+					return unit;
+				}
+			}
+		}
+		return nullptr;
+	}
+}
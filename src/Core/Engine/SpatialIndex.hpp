@@ -0,0 +1,288 @@
+//
+// Created by Carpov Pavel on 21.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SPATIALINDEX_HPP
+#define SW_BATTLE_TEST_SPATIALINDEX_HPP
+
+#include "Coordinate.hpp"
+#include "Core/Units/Unit.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace sw::core
+{
+	inline constexpr int32_t CHUNK_SIZE_LOG2 = 6;
+	inline constexpr int32_t CHUNK_SIZE = 1 << CHUNK_SIZE_LOG2; // chunk is CHUNK_SIZE x CHUNK_SIZE cells
+
+	// set of UnitLayer values a query wants to see
+	using LayerMask = uint8_t;
+	constexpr LayerMask layerBit(UnitLayer layer) noexcept { return static_cast<LayerMask>(1u << static_cast<uint8_t>(layer)); }
+	inline constexpr LayerMask LAYER_GROUND = layerBit(UnitLayer::Ground);
+	inline constexpr LayerMask LAYER_GROUND_OBJECT = layerBit(UnitLayer::GroundObject);
+	inline constexpr LayerMask LAYER_AIR = layerBit(UnitLayer::Air);
+	inline constexpr LayerMask LAYER_ALL = LAYER_GROUND | LAYER_GROUND_OBJECT | LAYER_AIR;
+
+	// per-layer shift of both range bounds, e.g. {0, 0, -1} shortens the reach against air targets by one cell
+	using LayerRangeAdjustment = std::array<int32_t, UNIT_LAYERS_COUNT>;
+
+	// teams a query sees, relative to the team of the query; a NO_TEAM query sees every team whatever the relation
+	enum class TeamRelation : uint8_t
+	{
+		Any,
+		Enemies, // every team except the query team
+		Allies // the query team only
+	};
+
+	// units around a position: range_min <= distance <= range_max (Chebyshev) with both bounds shifted by the
+	// adjustment of the unit layer, only units of the requested layers and teams having all required flags
+	struct RangeQuery
+	{
+		Coordinate position;
+		uint32_t rangeMax{0};
+		uint32_t rangeMin{1};
+		LayerMask layers{LAYER_ALL};
+		LayerRangeAdjustment adjustment{};
+		UnitFlags requiredFlags{0};
+		uint32_t team{NO_TEAM};
+		TeamRelation teams{TeamRelation::Any};
+		bool woundedOnly{false}; // walks the wounded lists of the chunks instead of their layers
+	};
+
+	// Sparse world storage: the map is split into fixed-size chunks, a chunk exists only while some unit is inside it.
+	// Memory is proportional to the peak number of occupied chunks, not to the map area.
+	// Inside a chunk units are split by layer, so a query never touches units of layers it did not ask for.
+	// Above the chunks units are split by team: enemy and ally queries never visit the chunks of the other side.
+	// Each chunk also lists its wounded units (UNIT_FLAG_WOUNDED), so heal queries only touch the injured ones.
+	class SpatialIndex
+	{
+		// units of one chunk per layer, each kept sorted by id so queries visit them in a reproducible order
+		struct Chunk
+		{
+			std::array<std::vector<Unit*>, UNIT_LAYERS_COUNT> layers;
+			// the wounded of every layer, sorted by id as well; room for all units of the chunk is kept, hits
+			// never allocate
+			std::vector<Unit*> wounded;
+
+			[[nodiscard]] bool empty() const noexcept
+			{
+				return std::all_of(layers.begin(), layers.end(), [](const auto& l) { return l.empty(); });
+			}
+		};
+		// ordered by (chunkX, chunkY): a column of chunks is a contiguous key range
+		using Chunks = std::map<uint64_t, Chunk>;
+		// chunks of the units of one team
+		struct Partition
+		{
+			uint32_t team{NO_TEAM};
+			Chunks chunks;
+		};
+		// ordered by team, created on the first unit of a team; scenarios without teams have the NO_TEAM one only
+		std::vector<Partition> partitions;
+		// nodes of dropped chunks, layer storage included: units crossing into empty chunks reuse them instead of
+		// allocating, so a warm index stops allocating once it has seen its peak number of chunks
+		std::vector<Chunks::node_type> spareChunks;
+		size_t createdChunks{0};
+
+		static int32_t chunkOf(int32_t cellCoordinate) noexcept { return cellCoordinate >> CHUNK_SIZE_LOG2; }
+		static uint64_t keyOf(int32_t chunkX, int32_t chunkY) noexcept
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+		}
+		static uint64_t keyOf(const Coordinate& c) noexcept { return keyOf(chunkOf(c.getX()), chunkOf(c.getY())); }
+		static int32_t chunkXOf(uint64_t key) noexcept { return static_cast<int32_t>(key >> 32); }
+
+		static void insertInto(Chunk& chunk, Unit* unit);
+		Chunks& chunksOf(uint32_t team);
+		// the chunk at the key, taken from the spare ones or created when there is none yet
+		Chunk& chunkAt(Chunks& chunks, uint64_t key);
+
+	public:
+		void insert(Unit* unit);
+		void remove(Unit* unit);
+		// updates the index for a unit that is about to move from its current position to 'to'
+		void relocate(Unit* unit, const Coordinate& to);
+		// lists or unlists an indexed unit whose HP changed, after the change
+		void updateWounded(Unit* unit);
+
+		[[nodiscard]] size_t getChunksCount() const noexcept
+		{
+			size_t count = 0;
+			for (const Partition& partition : partitions)
+			{
+				count += partition.chunks.size();
+			}
+			return count;
+		}
+
+		// solid unit at the cell, nullptr if none (looks at the ground layer only)
+		[[nodiscard]] Unit* findSolidAt(const Coordinate& c) const;
+
+		// scans units matching the query team by team, in chunk order inside a team and by id inside a chunk;
+		// fn(Unit*) returns false to stop early. Returns false if the scan was stopped
+		template <typename TFunc>
+		bool scan(const RangeQuery& query, TFunc&& fn) const
+		{
+			std::array<int64_t, UNIT_LAYERS_COUNT> maxOf{};
+			std::array<int64_t, UNIT_LAYERS_COUNT> minOf{};
+			int64_t r = -1;
+			for (size_t layer = 0; layer < UNIT_LAYERS_COUNT; ++layer)
+			{
+				maxOf[layer] = static_cast<int64_t>(query.rangeMax) + query.adjustment[layer];
+				minOf[layer] = std::max<int64_t>(0, static_cast<int64_t>(query.rangeMin) + query.adjustment[layer]);
+				if (query.layers & (1u << layer))
+				{
+					r = std::max(r, maxOf[layer]);
+				}
+			}
+			if (r < 0)
+			{
+				return true; // nothing is reachable
+			}
+			const Coordinate& position = query.position;
+			const int32_t minX = static_cast<int32_t>(std::max<int64_t>(0, position.getX() - r));
+			const int32_t minY = static_cast<int32_t>(std::max<int64_t>(0, position.getY() - r));
+			const int32_t maxX = static_cast<int32_t>(std::min<int64_t>(INT32_MAX, position.getX() + r));
+			const int32_t maxY = static_cast<int32_t>(std::min<int64_t>(INT32_MAX, position.getY() + r));
+			const auto visit = [&](Unit* unit)
+			{
+				if (!unit->hasFlags(query.requiredFlags))
+				{
+					return true;
+				}
+				const auto layer = static_cast<size_t>(unit->getLayer());
+				const int64_t distance = position.distance(unit->getPosition());
+				if (distance <= maxOf[layer] && distance >= minOf[layer])
+				{
+					return static_cast<bool>(fn(unit));
+				}
+				return true;
+			};
+			for (const Partition& partition : partitions)
+			{
+				if (sees(query, partition.team) &&
+					!forEachInChunksOf(partition.chunks, minX, minY, maxX, maxY, query.layers, visit, query.woundedOnly))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// calls fn(Unit*) for every unit of the requested layers inside the box [minX, maxX] x [minY, maxY]
+		// (inclusive, non-negative)
+		template <typename TFunc>
+		void forEachInBox(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, LayerMask layers, TFunc&& fn) const
+		{
+			const auto visit = [&](Unit* unit)
+			{
+				const Coordinate& p = unit->getPosition();
+				if (p.getX() >= minX && p.getX() <= maxX && p.getY() >= minY && p.getY() <= maxY)
+				{
+					fn(unit);
+				}
+				return true;
+			};
+			for (const Partition& partition : partitions)
+			{
+				forEachInChunksOf(partition.chunks, minX, minY, maxX, maxY, layers, visit);
+			}
+		}
+
+	private:
+		static bool sees(const RangeQuery& query, uint32_t team) noexcept
+		{
+			if (query.team == NO_TEAM || query.teams == TeamRelation::Any)
+			{
+				return true;
+			}
+			return (team == query.team) == (query.teams == TeamRelation::Allies);
+		}
+
+		// visits the requested layers of a chunk in id order, merging them when more than one is asked for (or its
+		// wounded of those layers); stops and returns false as soon as fn does
+		template <typename TFunc>
+		static bool forEachInChunk(const Chunk& chunk, LayerMask layers, TFunc& fn, bool woundedOnly)
+		{
+			if (woundedOnly)
+			{
+				for (Unit* unit : chunk.wounded)
+				{
+					if ((layers & layerBit(unit->getLayer())) && !fn(unit))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+			std::array<size_t, UNIT_LAYERS_COUNT> next{};
+			while (true)
+			{
+				Unit* first = nullptr;
+				size_t firstLayer = 0;
+				for (size_t layer = 0; layer < UNIT_LAYERS_COUNT; ++layer)
+				{
+					const auto& units = chunk.layers[layer];
+					if ((layers & (1u << layer)) && next[layer] < units.size() &&
+						(!first || units[next[layer]]->getId() < first->getId()))
+					{
+						first = units[next[layer]];
+						firstLayer = layer;
+					}
+				}
+				if (!first)
+				{
+					return true;
+				}
+				++next[firstLayer];
+				if (!fn(first))
+				{
+					return false;
+				}
+			}
+		}
+
+		// visits every unit of the requested layers in every chunk overlapping the box, callers filter by exact
+		// position. fn returns false to stop the walk
+		template <typename TFunc>
+		static bool forEachInChunksOf(const Chunks& chunks, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY,
+			LayerMask layers, TFunc&& fn, bool woundedOnly = false)
+		{
+			const int32_t chunkMinY = chunkOf(minY);
+			const int32_t chunkMaxY = chunkOf(maxY);
+
+			int32_t chunkX = chunkOf(minX);
+			const int32_t chunkMaxX = chunkOf(maxX);
+			while (chunkX <= chunkMaxX)
+			{
+				auto it = chunks.lower_bound(keyOf(chunkX, chunkMinY));
+				if (it == chunks.end())
+				{
+					return true;
+				}
+				// skip empty columns in one jump
+				if (chunkXOf(it->first) != chunkX)
+				{
+					chunkX = chunkXOf(it->first);
+					continue;
+				}
+				const uint64_t lastKey = keyOf(chunkX, chunkMaxY);
+				for (; it != chunks.end() && it->first <= lastKey; ++it)
+				{
+					if (!forEachInChunk(it->second, layers, fn, woundedOnly))
+					{
+						return false;
+					}
+				}
+				++chunkX;
+			}
+			return true;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SPATIALINDEX_HPP
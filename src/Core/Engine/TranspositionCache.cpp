@@ -0,0 +1,61 @@
+//
+// Created by Carpov Pavel on 25.10.2025.
+//
+
+#include "TranspositionCache.hpp"
+
+#include "ZobristHash.hpp"
+
+#include <stdexcept>
+
+namespace sw::core
+{
+	TranspositionCache::TranspositionCache(size_t capacity)
+	{
+		if (capacity == 0)
+		{
+			throw std::runtime_error("TranspositionCache: capacity must be positive");
+		}
+		size_t size = 1;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+		slots.resize(size);
+		mask = size - 1;
+	}
+
+	size_t TranspositionCache::slotOf(uint64_t worldHash, uint64_t randomState) const noexcept
+	{
+		return static_cast<size_t>(mixBits(worldHash ^ mixBits(randomState))) & mask;
+	}
+
+	std::optional<BattleOutcome> TranspositionCache::find(uint64_t worldHash, uint64_t randomState)
+	{
+		const Slot& exact = slots[slotOf(worldHash, randomState)];
+		if (exact.used && !exact.randomFree && exact.worldHash == worldHash && exact.randomState == randomState)
+		{
+			++hits;
+			return exact.outcome;
+		}
+		const Slot& randomFree = slots[slotOf(worldHash, 0)];
+		if (randomFree.used && randomFree.randomFree && randomFree.worldHash == worldHash)
+		{
+			++hits;
+			return randomFree.outcome;
+		}
+		++misses;
+		return std::nullopt;
+	}
+
+	void TranspositionCache::put(uint64_t worldHash, uint64_t randomState, bool randomFree, const BattleOutcome& outcome)
+	{
+		Slot& slot = slots[slotOf(worldHash, randomState)];
+		slot.worldHash = worldHash;
+		slot.randomState = randomState;
+		slot.outcome = outcome;
+		slot.used = true;
+		slot.randomFree = randomFree;
+		++stores;
+	}
+}
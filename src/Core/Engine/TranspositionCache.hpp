@@ -0,0 +1,66 @@
+//
+// Created by Carpov Pavel on 25.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_TRANSPOSITIONCACHE_HPP
+#define SW_BATTLE_TEST_TRANSPOSITIONCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace sw::core
+{
+	// how a battle ends when simulated from some state on
+	struct BattleOutcome
+	{
+		uint32_t roundsLeft{0}; // rounds still to play from the cached state
+		uint32_t survivors{0};
+		uint64_t finalHash{0};
+	};
+
+	// Bounded map (world hash, RNG state) -> known outcome, shared by the runs of a batch. The simulation is
+	// deterministic given both, so a run reaching a cached pair can stop right there.
+	// A state from which the rest of a run drew no random numbers has the same outcome under any RNG state, it is
+	// stored RNG-free and matches every run reaching it; this is what lets runs with different seeds meet.
+	// Fixed number of slots, a new entry replaces whatever shares its slot. Not thread-safe
+	class TranspositionCache
+	{
+		struct Slot
+		{
+			uint64_t worldHash{0};
+			uint64_t randomState{0};
+			BattleOutcome outcome;
+			bool used{false};
+			bool randomFree{false};
+		};
+		std::vector<Slot> slots;
+		size_t mask{0};
+		uint64_t hits{0};
+		uint64_t misses{0};
+		uint64_t stores{0};
+
+		[[nodiscard]] size_t slotOf(uint64_t worldHash, uint64_t randomState) const noexcept;
+		void put(uint64_t worldHash, uint64_t randomState, bool randomFree, const BattleOutcome& outcome);
+
+	public:
+		// capacity is rounded up to a power of two
+		explicit TranspositionCache(size_t capacity);
+
+		// exact (state, RNG state) entry first, then the RNG-free one
+		[[nodiscard]] std::optional<BattleOutcome> find(uint64_t worldHash, uint64_t randomState);
+		void store(uint64_t worldHash, uint64_t randomState, const BattleOutcome& outcome)
+		{
+			put(worldHash, randomState, false, outcome);
+		}
+		void storeRandomFree(uint64_t worldHash, const BattleOutcome& outcome) { put(worldHash, 0, true, outcome); }
+
+		[[nodiscard]] size_t getCapacity() const noexcept { return slots.size(); }
+		[[nodiscard]] uint64_t getHits() const noexcept { return hits; }
+		[[nodiscard]] uint64_t getMisses() const noexcept { return misses; }
+		[[nodiscard]] uint64_t getStores() const noexcept { return stores; }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_TRANSPOSITIONCACHE_HPP
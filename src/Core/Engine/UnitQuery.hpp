@@ -0,0 +1,154 @@
+//
+// Created by Carpov Pavel on 24.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITQUERY_HPP
+#define SW_BATTLE_TEST_UNITQUERY_HPP
+
+#include "Profiler.hpp"
+#include "SpatialIndex.hpp"
+#include "Random.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace sw::core
+{
+	// common target filters, all bits must be set on a unit
+	inline constexpr UnitFlags FILTER_DAMAGEABLE = UNIT_FLAG_HAS_HP;
+	inline constexpr UnitFlags FILTER_MELEE_TARGET = UNIT_FLAG_HAS_HP | UNIT_FLAG_MELEE_TARGETABLE;
+	inline constexpr UnitFlags FILTER_RANGED_TARGET = UNIT_FLAG_HAS_HP | UNIT_FLAG_RANGED_TARGETABLE;
+	inline constexpr UnitFlags FILTER_SOLID = UNIT_FLAG_SOLID;
+
+	// Builder over a spatial index range scan: filters are pushed down into the scan and terminal operations never
+	// materialize the matching units.
+	// worldState.queryUnits(pos).inRange(3, 2).onLayers(LAYER_GROUND).enemiesOf(team).where(FILTER_RANGED_TARGET).pickRandomOne()
+	class UnitQuery
+	{
+		const SpatialIndex& index;
+		Random& random;
+		RangeQuery query;
+
+	public:
+		UnitQuery(const SpatialIndex& index_, Random& random_, const Coordinate& position) : index(index_), random(random_)
+		{
+			query.position = position;
+		}
+
+		UnitQuery& inRange(uint32_t rangeMax, uint32_t rangeMin = 1) noexcept
+		{
+			query.rangeMax = rangeMax;
+			query.rangeMin = rangeMin;
+			return *this;
+		}
+		UnitQuery& onLayers(LayerMask layers) noexcept
+		{
+			query.layers = layers;
+			return *this;
+		}
+		UnitQuery& adjustRange(const LayerRangeAdjustment& adjustment) noexcept
+		{
+			query.adjustment = adjustment;
+			return *this;
+		}
+		// units of other teams only, the partitions of the team are not visited; every unit for NO_TEAM
+		UnitQuery& enemiesOf(uint32_t team) noexcept
+		{
+			query.team = team;
+			query.teams = TeamRelation::Enemies;
+			return *this;
+		}
+		// units of the team only, no other partition is visited; every unit for NO_TEAM
+		UnitQuery& alliesOf(uint32_t team) noexcept
+		{
+			query.team = team;
+			query.teams = TeamRelation::Allies;
+			return *this;
+		}
+		// adds required flags, see FILTER_* for the usual combinations
+		UnitQuery& where(UnitFlags required) noexcept
+		{
+			query.requiredFlags |= required;
+			return *this;
+		}
+		// wounded units only, read from the wounded lists: the scan costs the injured units around, not all of them
+		UnitQuery& wounded() noexcept
+		{
+			query.woundedOnly = true;
+			query.requiredFlags |= UNIT_FLAG_WOUNDED;
+			return *this;
+		}
+
+		// uniformly random matching unit, nullptr if none. Reservoir sampling over a single pass, no allocations
+		[[nodiscard]] Unit* pickRandomOne() const
+		{
+			SW_PROFILE_SCOPE("UnitQuery::pickRandomOne");
+			Unit* chosen = nullptr;
+			uint32_t seen = 0;
+			index.scan(query, [&](Unit* unit)
+			{
+				// k-th candidate replaces the choice with probability 1/k, the first one is taken without a draw
+				if (++seen == 1 || random.inRange(seen - 1) == 0)
+				{
+					chosen = unit;
+				}
+				return true;
+			});
+			return chosen;
+		}
+
+		// matching unit with the highest score(const Unit&), the first one in scan order on ties; nullptr if none.
+		// No draws
+		template <typename TScore>
+		[[nodiscard]] Unit* pickMax(TScore&& score) const
+		{
+			SW_PROFILE_SCOPE("UnitQuery::pickMax");
+			Unit* chosen = nullptr;
+			std::invoke_result_t<TScore&, const Unit&> best{};
+			index.scan(query, [&](Unit* unit)
+			{
+				const auto value = score(static_cast<const Unit&>(*unit));
+				if (!chosen || value > best)
+				{
+					chosen = unit;
+					best = value;
+				}
+				return true;
+			});
+			return chosen;
+		}
+
+		// stops at the first match
+		[[nodiscard]] bool any() const
+		{
+			SW_PROFILE_SCOPE("UnitQuery::any");
+			return !index.scan(query, [](Unit*) { return false; });
+		}
+
+		[[nodiscard]] uint32_t count() const
+		{
+			SW_PROFILE_SCOPE("UnitQuery::count");
+			uint32_t result = 0;
+			index.scan(query, [&result](Unit*)
+			{
+				++result;
+				return true;
+			});
+			return result;
+		}
+
+		// calls fn(Unit&) for every match in scan order
+		template <typename TFunc>
+		void forEach(TFunc&& fn) const
+		{
+			SW_PROFILE_SCOPE("UnitQuery::forEach");
+			index.scan(query, [&fn](Unit* unit)
+			{
+				fn(*unit);
+				return true;
+			});
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_UNITQUERY_HPP
@@ -1,15 +0,0 @@
-//
-// Created by Carpov Pavel on 26.09.2025.
-//
-
-#ifndef SW_BATTLE_TEST_UTIL_HPP
-#define SW_BATTLE_TEST_UTIL_HPP
-#include <cstdint>
-
-class Util
-{
-public:
-	static uint32_t randomInRange(uint32_t max, uint32_t min = 0);
-};
-
-#endif	//SW_BATTLE_TEST_UTIL_HPP
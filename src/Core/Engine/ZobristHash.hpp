@@ -0,0 +1,56 @@
+//
+// Created by Carpov Pavel on 25.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_ZOBRISTHASH_HPP
+#define SW_BATTLE_TEST_ZOBRISTHASH_HPP
+
+#include <cstdint>
+
+namespace sw::core
+{
+	// parts of a unit state covered by the world hash
+	enum class HashComponent : uint8_t
+	{
+		Position,
+		Hp,
+		Target,
+		Triggered,
+		Team
+	};
+
+	// splitmix64 finalizer: a cheap bijective 64-bit mix
+	constexpr uint64_t mixBits(uint64_t value) noexcept
+	{
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ULL;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebULL;
+		value ^= value >> 31;
+		return value;
+	}
+
+	// Incremental 64-bit Zobrist hash of the world: the XOR of one key per (unit, component, value).
+	// The key domain (every id x every cell x every hp) is far too large for a random table, so keys are derived from
+	// the triple with a keyed mix instead. A change costs two toggles: the old value out, the new value in.
+	class ZobristHash
+	{
+		uint64_t value{0};
+
+	public:
+		static constexpr uint64_t keyOf(uint32_t unitId, HashComponent component, uint64_t componentValue) noexcept
+		{
+			return mixBits(mixBits((static_cast<uint64_t>(unitId) << 8 | static_cast<uint8_t>(component)) ^
+				0x9e3779b97f4a7c15ULL) ^ componentValue);
+		}
+
+		void toggle(uint32_t unitId, HashComponent component, uint64_t componentValue) noexcept
+		{
+			value ^= keyOf(unitId, component, componentValue);
+		}
+
+		[[nodiscard]] uint64_t get() const noexcept { return value; }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_ZOBRISTHASH_HPP
@@ -0,0 +1,246 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_ARCHETYPE_HPP
+#define SW_BATTLE_TEST_ARCHETYPE_HPP
+
+#include "Unit.hpp"
+
+#include <Core/Engine/Profiler.hpp>
+#include <IO/System/TraceWriter.hpp>
+#include <array>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace sw::core
+{
+	// A behaviour is a class template over the unit type (CRTP) holding its own stats and one action, reaching the
+	// common unit state through a static cast. It provides:
+	//   static constexpr const char* ACTION_NAME - profiler and trace name of its action
+	//   template <typename TWorld> bool tryToAct(TWorld& worldState) - true if the action was performed
+	//   void hashState(ZobristHash&) const - optional, only behaviours with hashed state
+	//   template <typename TArchive> void transfer(TArchive&) - its fields, see UnitArchive.hpp; and a default constructor
+	// Behaviours asking about their neighbours use TUnit::has<B> (B is part of the unit type, compile time) and
+	// unit.uses<B>() (B is in the action order of this unit).
+	namespace details
+	{
+		template <typename TBehaviour, typename TUnit, typename TWorld>
+		bool tryAction(TUnit& unit, TWorld& worldState)
+		{
+			SW_PROFILE_NAMED_SCOPE(actionScope, TBehaviour::ACTION_NAME);
+			TraceSpan actionSpan(worldState.getTracer(), TBehaviour::ACTION_NAME, {"unitId", unit.getId()});
+			const bool executed = static_cast<TBehaviour&>(unit).tryToAct(worldState);
+			SW_PROFILE_RESULT(actionScope, executed);
+			actionSpan.setArg("executed", executed);
+			if (executed)
+			{
+				unit.consumeAction();
+			}
+			return executed;
+		}
+
+		template <typename TUnit, typename TWorld>
+		void wait(TUnit& unit, TWorld& worldState)
+		{
+			SW_PROFILE_NAMED_SCOPE(waitScope, "Wait");
+			TraceSpan waitSpan(worldState.getTracer(), "Wait", {"unitId", unit.getId()});
+			unit.consumeAction();
+		}
+
+		template <typename TBehaviour>
+		void hashBehaviour(const TBehaviour& behaviour, ZobristHash& hash)
+		{
+			if constexpr (requires(ZobristHash& h) { behaviour.hashState(h); })
+			{
+				behaviour.hashState(hash);
+			}
+		}
+	}
+
+	// A unit kind as a compile-time list of behaviours: Archetype<MeleeAttackBehaviour, MoveBehaviour>.
+	// The list order is the action order: each turn the first behaviour whose action succeeds wins, none succeeding
+	// means Wait. No virtual calls, the whole turn is inlined into the map loop.
+	template <template <typename> class... TBehaviours>
+	class Archetype final : public Unit, public TBehaviours<Archetype<TBehaviours...>>...
+	{
+	public:
+		// behaviours are passed in list order: SwordsmanUnit unit(true, {strength}, {})
+		explicit Archetype(bool solid_, TBehaviours<Archetype>... behaviours)
+			: Unit(solid_), TBehaviours<Archetype>(std::move(behaviours))...
+		{
+		}
+
+		template <template <typename> class TBehaviour>
+		static constexpr bool has = (std::is_same_v<TBehaviour<Archetype>, TBehaviours<Archetype>> || ...);
+		template <template <typename> class TBehaviour>
+		[[nodiscard]] static constexpr bool uses() noexcept { return has<TBehaviour>; }
+
+		// common state plus the state of every behaviour having some
+		void hashState(ZobristHash& hash) const
+		{
+			Unit::hashState(hash);
+			(details::hashBehaviour(static_cast<const TBehaviours<Archetype>&>(*this), hash), ...);
+		}
+		// called by the map on place (the hash) and removal (nullptr); the id must not change while attached
+		void attachHash(ZobristHash* hash)
+		{
+			if (getWorldHash())
+			{
+				hashState(*getWorldHash());
+			}
+			setWorldHash(hash);
+			if (hash)
+			{
+				hashState(*hash);
+			}
+		}
+
+		// the whole unit state, common part first, then the behaviours in list order
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			Unit::transfer(archive);
+			(static_cast<TBehaviours<Archetype>&>(*this).transfer(archive), ...);
+		}
+		// unit rebuilt from a record written by transfer()
+		template <typename TArchive>
+		static Archetype restore(TArchive& archive)
+		{
+			Archetype unit(true, TBehaviours<Archetype>{}...);
+			unit.transfer(archive);
+			return unit;
+		}
+
+		// tries the actions in behaviour order, the first one performed ends the attempt
+		template <typename TWorld>
+		[[nodiscard]] bool tryToExecuteNextAction(TWorld& worldState)
+		{
+			if ((details::tryAction<TBehaviours<Archetype>>(*this, worldState) || ...))
+			{
+				return true;
+			}
+			details::wait(*this, worldState);
+			return false;
+		}
+	};
+
+	// action order of a TableArchetype unit: indices into its behaviour list, packed into one word
+	inline constexpr size_t MAX_TABLE_ACTIONS = 7;
+	struct ActionTable
+	{
+		std::array<uint8_t, MAX_TABLE_ACTIONS> actions{};
+		uint8_t count{0};
+	};
+
+	// A unit kind whose action order is data: the behaviour list holds every behaviour a definition may use, the
+	// action table of the unit picks and orders them. Each step of the table switches on a compile-time index into
+	// the inlined behaviour bodies, no virtual calls either. Behaviours missing from the table keep default stats and
+	// never act.
+	template <template <typename> class... TBehaviours>
+	class TableArchetype final : public Unit, public TBehaviours<TableArchetype<TBehaviours...>>...
+	{
+		ActionTable actionTable;
+
+		template <typename TWorld, size_t... I>
+		bool tryTableAction(uint8_t action, TWorld& worldState, std::index_sequence<I...>)
+		{
+			bool executed = false;
+			(void)((action == I && (executed = details::tryAction<TBehaviours<TableArchetype>>(*this, worldState), true)) || ...);
+			return executed;
+		}
+
+	public:
+		explicit TableArchetype(bool solid_, bool flying_, const ActionTable& actionTable_, TBehaviours<TableArchetype>... behaviours)
+			: Unit(solid_, flying_), TBehaviours<TableArchetype>(std::move(behaviours))..., actionTable(actionTable_)
+		{
+		}
+
+		template <template <typename> class TBehaviour>
+		static constexpr bool has = (std::is_same_v<TBehaviour<TableArchetype>, TBehaviours<TableArchetype>> || ...);
+		// position of the behaviour in the list, the action code stored in tables
+		template <template <typename> class TBehaviour>
+		static constexpr uint8_t actionOf() noexcept
+		{
+			static_assert(has<TBehaviour>, "TableArchetype: behaviour is not in the list");
+			uint8_t index = 0;
+			(void)((std::is_same_v<TBehaviour<TableArchetype>, TBehaviours<TableArchetype>> || (++index, false)) || ...);
+			return index;
+		}
+		// action code of the behaviour with this ACTION_NAME, nullopt if there is none
+		[[nodiscard]] static std::optional<uint8_t> actionNamed(std::string_view name) noexcept
+		{
+			std::optional<uint8_t> result;
+			uint8_t index = 0;
+			(void)(((name == TBehaviours<TableArchetype>::ACTION_NAME && (result = index, true)) || (++index, false)) || ...);
+			return result;
+		}
+		template <template <typename> class TBehaviour>
+		[[nodiscard]] bool uses() const noexcept
+		{
+			if constexpr (has<TBehaviour>)
+			{
+				for (uint8_t i = 0; i < actionTable.count; ++i)
+				{
+					if (actionTable.actions[i] == actionOf<TBehaviour>())
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		void hashState(ZobristHash& hash) const
+		{
+			Unit::hashState(hash);
+			(details::hashBehaviour(static_cast<const TBehaviours<TableArchetype>&>(*this), hash), ...);
+		}
+		void attachHash(ZobristHash* hash)
+		{
+			if (getWorldHash())
+			{
+				hashState(*getWorldHash());
+			}
+			setWorldHash(hash);
+			if (hash)
+			{
+				hashState(*hash);
+			}
+		}
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			Unit::transfer(archive);
+			archive.field(actionTable.actions);
+			archive.field(actionTable.count);
+			(static_cast<TBehaviours<TableArchetype>&>(*this).transfer(archive), ...);
+		}
+		template <typename TArchive>
+		static TableArchetype restore(TArchive& archive)
+		{
+			TableArchetype unit(true, false, ActionTable{}, TBehaviours<TableArchetype>{}...);
+			unit.transfer(archive);
+			return unit;
+		}
+
+		template <typename TWorld>
+		[[nodiscard]] bool tryToExecuteNextAction(TWorld& worldState)
+		{
+			for (uint8_t i = 0; i < actionTable.count; ++i)
+			{
+				if (tryTableAction(actionTable.actions[i], worldState, std::make_index_sequence<sizeof...(TBehaviours)>{}))
+				{
+					return true;
+				}
+			}
+			details::wait(*this, worldState);
+			return false;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_ARCHETYPE_HPP
@@ -0,0 +1,140 @@
+//
+// Created by Carpov Pavel on 28.09.2025.
+//
+#ifndef SW_BATTLE_TEST_ATTACKBEHAVIOURS_HPP
+#define SW_BATTLE_TEST_ATTACKBEHAVIOURS_HPP
+#include "Core/Engine/UnitQuery.hpp"
+#include "Unit.hpp"
+
+#include <cstdint>
+
+namespace sw::core
+{
+	inline constexpr uint32_t MAX_MELEE_ATTACK_RANGE = 1;
+	inline constexpr uint32_t MIN_MELEE_ATTACK_RANGE = 1;
+	// melee reaches ground units only; ground objects (mines) never take damage
+	inline constexpr LayerMask MELEE_TARGET_LAYERS = LAYER_GROUND;
+	template <typename TUnit>
+	class MeleeAttackBehaviour
+	{
+		uint32_t strength{0};
+
+		const TUnit& self() const noexcept { return static_cast<const TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "MeleeAttack";
+
+		MeleeAttackBehaviour() = default;
+		MeleeAttackBehaviour(uint32_t strength_) : strength(strength_) {}
+		void setStrength(uint32_t v) noexcept { strength = v; }
+		[[nodiscard]] uint32_t getStrength() const noexcept { return strength; }
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(strength);
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			// attack a random adjacent enemy
+			Unit* targetUnit = worldState.queryUnits(self().getPosition())
+								   .inRange(MAX_MELEE_ATTACK_RANGE, MIN_MELEE_ATTACK_RANGE)
+								   .onLayers(MELEE_TARGET_LAYERS)
+								   .enemiesOf(self().getTeam())
+								   .where(FILTER_MELEE_TARGET)
+								   .pickRandomOne();
+			if (!targetUnit)
+			{
+				return false;
+			}
+
+			// apply damage, the batch logs the attack and possible death
+			worldState.getDamageBatch().add(self().getId(), *targetUnit, strength);
+			worldState.applyDamage();
+
+			return true;
+		}
+	};
+
+	inline constexpr uint32_t MIN_RANGED_ATTACK_RANGE = 2;
+	inline constexpr LayerMask RANGED_TARGET_LAYERS = LAYER_GROUND | LAYER_AIR;
+	// air targets are one cell closer for both range bounds
+	inline constexpr LayerRangeAdjustment RANGED_RANGE_ADJUSTMENT{0, 0, -1};
+	template <typename TUnit>
+	class RangedAttackBehaviour
+	{
+		uint32_t agility{0}; // aka Power for towers
+		uint32_t range_max{0};
+		uint32_t range_min{2}; // min range for ranged attacks (1 = melee)
+
+		const TUnit& self() const noexcept { return static_cast<const TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "RangedAttack";
+
+		RangedAttackBehaviour() = default;
+		RangedAttackBehaviour(uint32_t agility_, uint32_t range_min_, uint32_t range_max_)
+			: agility(agility_), range_max(range_max_), range_min(range_min_)
+		{
+		}
+
+		void setAgility(uint32_t v) noexcept { agility = v; }
+		[[nodiscard]] uint32_t getAgility() const noexcept { return agility; }
+
+		void setRange(uint32_t v) noexcept { range_max = v; }
+		[[nodiscard]] uint32_t getRange() const noexcept { return range_max; }
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(agility);
+			archive.field(range_max);
+			archive.field(range_min);
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			// units that can fight in melee (hunters) do not shoot while an enemy is adjacent
+			if constexpr (TUnit::template has<MeleeAttackBehaviour>)
+			{
+				if (self().template uses<MeleeAttackBehaviour>())
+				{
+					const bool adjacentUnits = worldState.queryUnits(self().getPosition())
+												   .inRange(MAX_MELEE_ATTACK_RANGE)
+												   .onLayers(MELEE_TARGET_LAYERS)
+												   .enemiesOf(self().getTeam())
+												   .where(FILTER_MELEE_TARGET)
+												   .any();
+					if (adjacentUnits) // adjacent enemies present, disallow ranged attack
+					{
+						return false;
+					}
+				}
+			}
+
+			// pick random enemy target
+			Unit* targetUnit = worldState.queryUnits(self().getPosition())
+								   .inRange(range_max, range_min)
+								   .onLayers(RANGED_TARGET_LAYERS)
+								   .adjustRange(RANGED_RANGE_ADJUSTMENT)
+								   .enemiesOf(self().getTeam())
+								   .where(FILTER_RANGED_TARGET)
+								   .pickRandomOne();
+			if (!targetUnit)
+			{
+				return false;
+			}
+
+			// apply damage, the batch logs the attack and possible death
+			worldState.getDamageBatch().add(self().getId(), *targetUnit, agility);
+			worldState.applyDamage();
+
+			return true;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_ATTACKBEHAVIOURS_HPP
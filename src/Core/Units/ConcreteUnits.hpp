@@ -1,96 +1,39 @@
 #pragma once
 
-#include "AttackingUnit.hpp"
-#include "ExplodingUnit.hpp"
-#include "HealingUnit.hpp"
-#include "MovingUnit.hpp"
-#include "TriggeredUnit.hpp"
-#include "Unit.hpp"
+#include "Archetype.hpp"
+#include "AttackBehaviours.hpp"
+#include "ExplodeBehaviour.hpp"
+#include "HealBehaviour.hpp"
+#include "MoveBehaviour.hpp"
+#include "PlannedArchetype.hpp"
+#include "TriggerBehaviour.hpp"
+#include "UnitStorage.hpp"
 
 namespace sw::core
 {
-	class SwordsmanUnit : public MovingUnit, public MeleeAttackingUnit
-	{
-	public:
-		explicit SwordsmanUnit(uint32_t strength_) : Unit(true), MeleeAttackingUnit(strength_) {}
-		[[nodiscard]] const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept
-		{
-			static const std::vector<ActionTypeBase*> types = {&MeleeAttackActionType, &MoveActionType};
-			return types;
-		}
-	};
+	// unit kinds, the behaviour list is the action order
+	using SwordsmanUnit = Archetype<MeleeAttackBehaviour, MoveBehaviour>;
 
 	inline constexpr uint32_t HUNTER_MIN_ATTACK_RANGE{2};
-	class HunterUnit : public MovingUnit, public MeleeAttackingUnit, public RangedAttackingUnit
-	{
-	public:
-		explicit HunterUnit(uint32_t strength_, uint32_t agility_, uint32_t range_max_)
-			: Unit(true), MeleeAttackingUnit(strength_), RangedAttackingUnit(agility_, HUNTER_MIN_ATTACK_RANGE, range_max_) {}
-		[[nodiscard]] const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept
-		{
-			static const std::vector<ActionTypeBase*> types = {&RangedAttackActionType, &MeleeAttackActionType, &MoveActionType};
-			return types;
-		}
+	// a melee behaviour in the list keeps the ranged attack back while enemies are adjacent
+	using HunterUnit = Archetype<RangedAttackBehaviour, MeleeAttackBehaviour, MoveBehaviour>;
 
-		// Hunters restrict ranged attacks when adjacent (melee) units are present.
-		[[nodiscard]] bool disallowRangedIfAdjacent() const noexcept { return true; }
-	};
+	using TowerUnit = Archetype<RangedAttackBehaviour>;
 
-	class TowerUnit : public Unit
-	{
-	public:
-		TowerUnit() : Unit(true) {}
-		[[nodiscard]] const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept
-		{
-			static const std::vector<ActionTypeBase*> types = {&RangedAttackActionType};
-			return types;
-		}
-	};
+	using HealerUnit = Archetype<HealBehaviour, MoveBehaviour>;
 
-	class HealerUnit : public MovingUnit, public HealingUnit
-	{
-	public:
-		HealerUnit(uint32_t spirit_, uint32_t healingRange_) : Unit(true), HealingUnit(spirit_, healingRange_) {}
-		[[nodiscard]] const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept
-		{
-			static const std::vector<ActionTypeBase*> types = {&HealActionType, &MoveActionType};
-			return types;
-		}
-	};
+	// not moving. Trigger is after Explode to ensure mine explodes on the next turn after triggering
+	using MineUnit = Archetype<ExplodeBehaviour, TriggerBehaviour>;
 
-	class MineUnit : public ExplodingUnit, public TriggeredUnit// not MovingUnit
-	{
-	public:
-		MineUnit(uint32_t power_, uint32_t trigger_range_, uint32_t explosion_range_)
-		: Unit(false), ExplodingUnit(power_, explosion_range_), TriggeredUnit(trigger_range_)
-		{
-			setName("Mine");
-		}
+	// kinds from the unit definitions file (UnitDefinitions.hpp): every behaviour a definition may list
+	using DefinedUnit = TableArchetype<MeleeAttackBehaviour, RangedAttackBehaviour, MoveBehaviour, HealBehaviour,
+		ExplodeBehaviour, TriggerBehaviour>;
 
-		[[nodiscard]] const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept override
-		{
-			// Trigger is after Explode to ensure mine explodes on the next turn after triggering
-			static const std::vector<ActionTypeBase*> types = {&ExplodeAttackActionType, &TriggerActionType};
-			return types;
-		}
+	// kinds from the definitions file that run a plan instead of an action order: every behaviour a plan acts through
+	using PlannedUnit = PlannedArchetype<MeleeAttackBehaviour, RangedAttackBehaviour, MoveBehaviour>;
 
-		bool shouldExplodeNow() const noexcept override
-		{
-			return isTriggered();
-		}
-
-		void onActionExecuted(ActionTypeBase* actionType) override
-		{
-			Unit::onActionExecuted(actionType);
-			// mine explodes and is destroyed
-			// Action::actionType stores a pointer to the singleton ActionTypeBase instance.
-			// Compare by pointer to the inline singleton object.
-			if (actionType == &ExplodeAttackActionType)
-			{
-				setHp(0);
-			}
-		}
-	};
+	// every archetype the map can hold, a new unit kind is registered here
+	using UnitArchetypeStorage =
+		UnitStorage<SwordsmanUnit, HunterUnit, TowerUnit, HealerUnit, MineUnit, DefinedUnit, PlannedUnit>;
 
 } // namespace sw::core
-
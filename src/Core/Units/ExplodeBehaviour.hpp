@@ -0,0 +1,76 @@
+//
+// Created by Carpov Pavel on 28.09.2025.
+//
+
+#ifndef SW_BATTLE_TEST_EXPLODEBEHAVIOUR_HPP
+#define SW_BATTLE_TEST_EXPLODEBEHAVIOUR_HPP
+#include "Core/Engine/UnitQuery.hpp"
+#include "IO/Events/UnitExploded.hpp"
+#include "IO/System/EventLog.hpp"
+#include "TriggerBehaviour.hpp"
+#include "Unit.hpp"
+
+namespace sw::core
+{
+	// damages every enemy around once armed by the TriggerBehaviour of the same unit, the explosion destroys the unit.
+	// Put it before the trigger in the behaviour list to explode on the turn after triggering
+	template <typename TUnit>
+	class ExplodeBehaviour
+	{
+	private:
+		uint32_t explosionRange{1};
+		uint32_t power{1}; // damage dealt by explosion
+
+		TUnit& self() noexcept { return static_cast<TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "ExplodeAttack";
+
+		ExplodeBehaviour() = default;
+		ExplodeBehaviour(uint32_t power_, uint32_t explosionRange_) : explosionRange(explosionRange_), power(power_) {}
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(explosionRange);
+			archive.field(power);
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			if constexpr (!TUnit::template has<TriggerBehaviour>)
+			{
+				return false; // nothing arms it
+			}
+			else
+			{
+				if (!self().isTriggered())
+				{
+					return false;
+				}
+				auto damage = power; // uint32_t
+				// collect hits during the scan, then apply them in one pass
+				auto& batch = worldState.getDamageBatch();
+				worldState.queryUnits(self().getPosition())
+					.inRange(explosionRange)
+					.onLayers(LAYER_GROUND | LAYER_AIR)
+					.enemiesOf(self().getTeam())
+					.where(FILTER_DAMAGEABLE)
+					.forEach([&](Unit& targetUnit) { batch.add(self().getId(), targetUnit, damage); });
+				const auto unitsHit = static_cast<uint32_t>(batch.size());
+				if (unitsHit == 0)
+				{
+					return false;
+				}
+				worldState.applyDamage();
+				worldState.eventLog_.template emit<sw::io::UnitExploded>(worldState.getCurrentTick(), [&]
+					{ return sw::io::UnitExploded{self().getId(), power, unitsHit}; });
+				// the mine is destroyed by its own explosion
+				self().setHp(0);
+				return true;
+			}
+		}
+	};
+}
+#endif	//SW_BATTLE_TEST_EXPLODEBEHAVIOUR_HPP
@@ -0,0 +1,86 @@
+//
+// Created by Carpov Pavel on 29.09.2025.
+//
+
+#ifndef SW_BATTLE_TEST_HEALBEHAVIOUR_HPP
+#define SW_BATTLE_TEST_HEALBEHAVIOUR_HPP
+#include "Core/Engine/UnitQuery.hpp"
+#include "Unit.hpp"
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+namespace sw::core
+{
+	// which wounded ally a healer picks
+	enum class HealTarget : uint8_t
+	{
+		RandomWounded,
+		MostWounded // the most HP missing, the lowest id on ties
+	};
+	inline constexpr std::array<std::string_view, 2> HEAL_TARGET_NAMES{"RandomWounded", "MostWounded"};
+
+	[[nodiscard]] inline std::optional<HealTarget> healTargetNamed(std::string_view name) noexcept
+	{
+		for (size_t i = 0; i < HEAL_TARGET_NAMES.size(); ++i)
+		{
+			if (HEAL_TARGET_NAMES[i] == name)
+			{
+				return static_cast<HealTarget>(i);
+			}
+		}
+		return std::nullopt;
+	}
+
+	template <typename TUnit>
+	class HealBehaviour
+	{
+	private:
+		uint32_t healingRange{1};
+		uint32_t spirit{1}; // hp restored by one heal
+		HealTarget target{HealTarget::RandomWounded};
+
+		const TUnit& self() const noexcept { return static_cast<const TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "Heal";
+
+		HealBehaviour() = default;
+		HealBehaviour(uint32_t spirit_, uint32_t healingRange_, HealTarget target_ = HealTarget::RandomWounded)
+			: healingRange(healingRange_), spirit(spirit_), target(target_)
+		{
+		}
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(healingRange);
+			archive.field(spirit);
+			archive.field(target);
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			// heal a wounded ally, units at full hp are not worth the action
+			auto query = worldState.queryUnits(self().getPosition())
+							 .inRange(healingRange)
+							 .onLayers(LAYER_GROUND | LAYER_AIR)
+							 .alliesOf(self().getTeam())
+							 .where(FILTER_DAMAGEABLE)
+							 .wounded();
+			Unit* targetUnit = target == HealTarget::MostWounded
+				? query.pickMax([](const Unit& unit) { return unit.getMissingHp(); })
+				: query.pickRandomOne();
+			if (!targetUnit)
+			{
+				return false;
+			}
+			worldState.heal(self().getId(), *targetUnit, spirit);
+			return true;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_HEALBEHAVIOUR_HPP
@@ -0,0 +1,94 @@
+//
+// Created by Carpov Pavel on 28.09.2025.
+//
+
+#ifndef SW_BATTLE_TEST_MOVEBEHAVIOUR_HPP
+#define SW_BATTLE_TEST_MOVEBEHAVIOUR_HPP
+#include "Core/Engine/MoveKernel.hpp"
+#include "IO/Events/UnitMoved.hpp"
+#include "IO/System/EventLog.hpp"
+#include "Unit.hpp"
+
+#include <optional>
+
+namespace sw::core
+{
+	// steps towards the march target, the target is optional: unit may have no movement target
+	template <typename TUnit>
+	class MoveBehaviour
+	{
+	private:
+		std::optional<Coordinate> targetPosition{};
+		uint32_t speed{1}; // tiles per move action
+
+		TUnit& self() noexcept { return static_cast<TUnit&>(*this); }
+		const TUnit& self() const noexcept { return static_cast<const TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "Move";
+
+		MoveBehaviour(uint32_t speed_ = 1) : speed(speed_) {}
+
+		[[nodiscard]] uint32_t getSpeed() const noexcept { return speed; }
+		[[nodiscard]] bool hasTarget() const noexcept { return targetPosition.has_value(); }
+		[[nodiscard]] const std::optional<Coordinate>& getTarget() const noexcept { return targetPosition; }
+		void setTarget(const Coordinate& coord)
+		{
+			clearTarget();
+			targetPosition = coord;
+			self().toggleHash(HashComponent::Target, Unit::packCoordinate(coord));
+		}
+		void clearTarget() noexcept
+		{
+			if (targetPosition)
+			{
+				self().toggleHash(HashComponent::Target, Unit::packCoordinate(*targetPosition));
+				targetPosition.reset();
+			}
+		}
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(targetPosition);
+			archive.field(speed);
+		}
+
+		void hashState(ZobristHash& hash) const
+		{
+			if (targetPosition)
+			{
+				hash.toggle(self().getId(), HashComponent::Target, Unit::packCoordinate(*targetPosition));
+			}
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			if (!targetPosition.has_value())
+			{
+				return false;
+			}
+			const Coordinate& position = self().getPosition();
+			if (targetPosition.value() == position)
+			{
+				return false;
+			}
+			// best free step towards the target, integer direction table for speed 1
+			const std::optional<Coordinate> step = move_kernel::chooseStep(position, *targetPosition, speed, [&](const Coordinate& coord)
+				{ return worldState.isValidCoordinate(coord) && !(self().isSolid() && worldState.isOccupied(coord)); });
+			if (!step)
+			{
+				return false;
+			}
+			const Coordinate nextCoord = *step;
+			worldState.moveUnit(self(), nextCoord);
+
+			worldState.eventLog_.template emit<sw::io::UnitMoved>(worldState.getCurrentTick(), [&]
+				{ return sw::io::UnitMoved{self().getId(), static_cast<uint32_t>(nextCoord.getX()), static_cast<uint32_t>(nextCoord.getY())}; });
+			return true;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_MOVEBEHAVIOUR_HPP
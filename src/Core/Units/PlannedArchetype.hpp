@@ -0,0 +1,184 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_PLANNEDARCHETYPE_HPP
+#define SW_BATTLE_TEST_PLANNEDARCHETYPE_HPP
+
+#include "Archetype.hpp"
+#include "UnitPlan.hpp"
+#include "UnitPlans.hpp"
+
+#include <Core/Engine/PlanScheduler.hpp>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+namespace sw::core
+{
+	// A unit kind driven by a plan (UnitPlan.hpp) instead of an action order: the plan coroutine remembers where the
+	// unit is in its behaviour between turns and tells the scheduler when to play it again, a waiting unit passes its
+	// turn without evaluating anything. The behaviour list holds every behaviour a plan may act through.
+	template <template <typename> class... TBehaviours>
+	class PlannedArchetype final : public Unit, public TBehaviours<PlannedArchetype<TBehaviours...>>...
+	{
+		// the coroutine points at its unit: plans start once the unit is stored and stop before it is removed, a
+		// running plan is never moved
+		struct RunningPlan
+		{
+			UnitPlan coroutine;
+			PlanSleep sleep;
+
+			RunningPlan() = default;
+			RunningPlan([[maybe_unused]] RunningPlan&& other) noexcept
+			{
+				assert(!other.coroutine && "PlannedArchetype: a running plan cannot be moved");
+			}
+			RunningPlan& operator=([[maybe_unused]] RunningPlan&& other) noexcept
+			{
+				assert(!coroutine && !other.coroutine && "PlannedArchetype: a running plan cannot be moved");
+				return *this;
+			}
+		};
+		UnitPlanKind planKind;
+		RunningPlan plan;
+
+		template <typename TWorld>
+		void waitFor(const PlanWait& wait, TWorld& worldState)
+		{
+			PlanScheduler& scheduler = worldState.getPlanScheduler();
+			switch (wait.wake)
+			{
+				case PlanWake::NextTurn:
+					break;
+				case PlanWake::Round:
+					if (wait.rounds > 1)
+					{
+						PlanScheduler::sleepUntil(plan.sleep, worldState.getCurrentTick() + wait.rounds);
+					}
+					break;
+				case PlanWake::EnemyWithin:
+				{
+					// one is in range already: the next turn is when it wakes
+					const PlanWatch& watch = wait.watch;
+					const bool inRange = worldState.queryUnits(getPosition())
+											 .inRange(watch.range)
+											 .onLayers(watch.layers)
+											 .enemiesOf(getTeam())
+											 .where(watch.requiredFlags)
+											 .any();
+					if (!inRange)
+					{
+						scheduler.watch(plan.sleep, getPosition(), getTeam(), watch);
+					}
+					break;
+				}
+			}
+		}
+
+	public:
+		explicit PlannedArchetype(bool solid_, bool flying_, UnitPlanKind planKind_, TBehaviours<PlannedArchetype>... behaviours)
+			: Unit(solid_, flying_), TBehaviours<PlannedArchetype>(std::move(behaviours))..., planKind(planKind_)
+		{
+		}
+
+		template <template <typename> class TBehaviour>
+		static constexpr bool has = (std::is_same_v<TBehaviour<PlannedArchetype>, TBehaviours<PlannedArchetype>> || ...);
+		// the behaviours of its plan, UNIT_PLAN_ACTIONS
+		template <template <typename> class TBehaviour>
+		[[nodiscard]] bool uses() const noexcept
+		{
+			if constexpr (has<TBehaviour>)
+			{
+				return unitPlanUses(planKind, TBehaviour<PlannedArchetype>::ACTION_NAME);
+			}
+			return false;
+		}
+
+		// the plan is not part of the state: it plays like the action order of its behaviours, the hashed state
+		// alone decides what the unit does next
+		void hashState(ZobristHash& hash) const
+		{
+			Unit::hashState(hash);
+			(details::hashBehaviour(static_cast<const TBehaviours<PlannedArchetype>&>(*this), hash), ...);
+		}
+		void attachHash(ZobristHash* hash)
+		{
+			if (getWorldHash())
+			{
+				hashState(*getWorldHash());
+			}
+			setWorldHash(hash);
+			if (hash)
+			{
+				hashState(*hash);
+			}
+		}
+
+		// the plan kind, not where the plan is: a unit handed to another shard starts its plan over
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			Unit::transfer(archive);
+			archive.field(planKind);
+			(static_cast<TBehaviours<PlannedArchetype>&>(*this).transfer(archive), ...);
+		}
+		template <typename TArchive>
+		static PlannedArchetype restore(TArchive& archive)
+		{
+			PlannedArchetype unit(true, false, UnitPlanKind{}, TBehaviours<PlannedArchetype>{}...);
+			unit.transfer(archive);
+			return unit;
+		}
+
+		// called by the map once the unit is stored, the plan plays from the next turn of the unit
+		template <typename TWorld>
+		void startPlan(TWorld& worldState)
+		{
+			assert(!plan.coroutine && "PlannedArchetype::startPlan: plan is already running");
+			plan.coroutine = startUnitPlan(planKind, *this, worldState);
+		}
+		// the unit leaves the map
+		void stopPlan(PlanScheduler& scheduler)
+		{
+			scheduler.wake(plan.sleep);
+			plan.coroutine.reset();
+		}
+		// a new order, the plan looks at it on the next turn
+		void wakePlan(PlanScheduler& scheduler) { scheduler.wake(plan.sleep); }
+
+		// the action of a behaviour, for the plan; true if it was performed
+		template <template <typename> class TBehaviour, typename TWorld>
+		bool act(TWorld& worldState)
+		{
+			static_assert(has<TBehaviour>, "PlannedArchetype: behaviour is not in the list");
+			assert(getAvailableActionsPerTurn() > 0 && "PlannedArchetype::act: the plan acted twice in a turn");
+			return details::tryAction<TBehaviour<PlannedArchetype>>(*this, worldState);
+		}
+
+		// one turn of the plan, or nothing while it waits
+		template <typename TWorld>
+		[[nodiscard]] bool tryToExecuteNextAction(TWorld& worldState)
+		{
+			if ((plan.sleep.waiting() && plan.sleep.waitingAt(worldState.getCurrentTick())) || plan.coroutine.done())
+			{
+				consumeAction();
+				return false;
+			}
+			const uint32_t actionsBefore = getAvailableActionsPerTurn();
+			plan.coroutine.resume();
+			const bool executed = getAvailableActionsPerTurn() < actionsBefore;
+			if (!executed)
+			{
+				details::wait(*this, worldState);
+			}
+			if (!plan.coroutine.done())
+			{
+				waitFor(plan.coroutine.getWait(), worldState);
+			}
+			return executed;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_PLANNEDARCHETYPE_HPP
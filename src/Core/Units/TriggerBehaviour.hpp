@@ -0,0 +1,64 @@
+//
+// Created by Carpov Pavel on 28.09.2025.
+//
+
+#ifndef SW_BATTLE_TEST_TRIGGERBEHAVIOUR_HPP
+#define SW_BATTLE_TEST_TRIGGERBEHAVIOUR_HPP
+#include "Core/Engine/UnitQuery.hpp"
+#include "Unit.hpp"
+
+namespace sw::core
+{
+	inline constexpr uint32_t DEFAULT_TRIGGER_RANGE = 2;
+	// arms the unit once an enemy ground unit comes within the trigger range, stays armed
+	template <typename TUnit>
+	class TriggerBehaviour
+	{
+	private:
+		bool triggered{false};
+		uint32_t triggerRange{DEFAULT_TRIGGER_RANGE};
+
+		const TUnit& self() const noexcept { return static_cast<const TUnit&>(*this); }
+
+	public:
+		static constexpr const char* ACTION_NAME = "Trigger";
+
+		TriggerBehaviour() = default;
+		TriggerBehaviour(uint32_t triggerRange_) : triggerRange(triggerRange_) {}
+
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(triggered);
+			archive.field(triggerRange);
+		}
+
+		[[nodiscard]] bool isTriggered() const noexcept { return triggered; }
+
+		void hashState(ZobristHash& hash) const
+		{
+			if (triggered)
+			{
+				hash.toggle(self().getId(), HashComponent::Triggered, 1);
+			}
+		}
+
+		template <typename TWorld>
+		bool tryToAct(TWorld& worldState)
+		{
+			// only solid ground units step on a mine, allies pass safely
+			if (worldState.queryUnits(self().getPosition()).inRange(triggerRange).onLayers(LAYER_GROUND).enemiesOf(self().getTeam()).any())
+			{
+				if (!triggered)
+				{
+					self().toggleHash(HashComponent::Triggered, 1);
+				}
+				triggered = true;
+				return true;
+			}
+			return false;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_TRIGGERBEHAVIOUR_HPP
@@ -4,20 +4,45 @@
 #pragma once
 
 #include <Core/Engine/Coordinate.hpp>
+#include <Core/Engine/ZobristHash.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace sw::core
 {
-	class ActionTypeBase;
-	class MapUnitsController;
-	class Action;
 	// inline constexpr uint32_t MIN_RANGED_ATTACK_RANGE = 2;
 
 	inline constexpr uint32_t DEFAULT_ACTIONS_PER_TURN = 1;
+	// team 0 is no faction: hostile to every unit and helped by every healer, as all units were before teams
+	inline constexpr uint32_t NO_TEAM = 0;
 
-	class Unit : public std::enable_shared_from_this<Unit>
+	// Where a unit lives in the spatial index, queries name the layers they need
+	enum class UnitLayer : uint8_t
+	{
+		Ground,		  // solid units, at most one per cell
+		GroundObject, // non-solid objects lying on a cell (mines)
+		Air			  // flying units, take no cell
+	};
+	inline constexpr size_t UNIT_LAYERS_COUNT = 3;
+
+	// Unit state bits, spatial queries test them inside the index scan instead of calling virtual predicates
+	using UnitFlags = uint8_t;
+	inline constexpr UnitFlags UNIT_FLAG_SOLID = 1 << 0;
+	inline constexpr UnitFlags UNIT_FLAG_HAS_HP = 1 << 1; // has HP and it is above zero
+	inline constexpr UnitFlags UNIT_FLAG_MELEE_TARGETABLE = 1 << 2;
+	inline constexpr UnitFlags UNIT_FLAG_RANGED_TARGETABLE = 1 << 3;
+	inline constexpr UnitFlags UNIT_FLAG_GHOST = 1 << 4; // read-only copy of a unit owned by a neighbouring shard
+	inline constexpr UnitFlags UNIT_FLAG_WOUNDED = 1 << 5; // alive with HP below its spawn HP, see SpatialIndex
+
+	// State every unit has. Not polymorphic: a unit kind is an Archetype combining Unit with its behaviours, the map
+	// stores units per archetype and calls them through their concrete type
+	class Unit
 	{
 	private:
 		std::string name;
@@ -25,38 +50,120 @@ namespace sw::core
 		// identity and common stats
 		uint32_t id{0};
 		std::optional<uint32_t> hp; // optional HP
+		uint32_t maxHp{0}; // spawn HP, heals restore up to it
 		uint32_t availableActionsNum{0}; // number of actions available in the current round
-		const bool solid{true}; // Fermion / Boson :) other units can move through this unit
+		uint32_t team{NO_TEAM}; // set before the unit is placed, the spatial index partitions units by it
+		bool solid{true}; // Fermion / Boson :) other units can move through this unit
+		bool flying{false}; // flying units are never solid
+		UnitFlags flags{UNIT_FLAG_MELEE_TARGETABLE | UNIT_FLAG_RANGED_TARGETABLE};
+		ZobristHash* worldHash{nullptr}; // hash of the map the unit is placed on, kept in sync by every setter
 
 	protected:
+		// units that cannot be reached by some kind of attack clear the corresponding flag in their constructor
+		void setTargetable(bool melee, bool ranged) noexcept
+		{
+			flags = static_cast<UnitFlags>((flags & ~(UNIT_FLAG_MELEE_TARGETABLE | UNIT_FLAG_RANGED_TARGETABLE)) |
+				(melee ? UNIT_FLAG_MELEE_TARGETABLE : 0) | (ranged ? UNIT_FLAG_RANGED_TARGETABLE : 0));
+		}
+		[[nodiscard]] ZobristHash* getWorldHash() const noexcept { return worldHash; }
+		void setWorldHash(ZobristHash* hash) noexcept { worldHash = hash; }
 
 	public:
-		// Unit no longer stores per-instance action lists. Subclasses provide them via getActionTypes().
-		explicit Unit(bool solid_) : solid(solid_) {}
-		virtual ~Unit() = default;
+		// the action order is not stored per instance, it is the behaviour list of the archetype
+		explicit Unit(bool solid_, bool flying_ = false) : solid(solid_ && !flying_), flying(flying_)
+		{
+			if (solid)
+			{
+				flags |= UNIT_FLAG_SOLID;
+			}
+		}
+
+		// every field of the common state, see UnitArchive.hpp; the world hash link is not part of it
+		template <typename TArchive>
+		void transfer(TArchive& archive)
+		{
+			archive.field(name);
+			archive.field(position);
+			archive.field(id);
+			archive.field(hp);
+			archive.field(maxHp);
+			archive.field(availableActionsNum);
+			archive.field(solid);
+			archive.field(flying);
+			archive.field(flags);
+			archive.field(team);
+		}
+		// ghosts are seen by queries and take hits, but never act; their owner applies what they take
+		void markGhost() noexcept { flags |= UNIT_FLAG_GHOST; }
+		[[nodiscard]] bool isGhost() const noexcept { return hasFlags(UNIT_FLAG_GHOST); }
+
+		// behaviours call this for their own hashed state, once with the old value and once with the new one
+		void toggleHash(HashComponent component, uint64_t value) const noexcept
+		{
+			if (worldHash)
+			{
+				worldHash->toggle(id, component, value);
+			}
+		}
+		static uint64_t packCoordinate(const Coordinate& c) noexcept
+		{
+			return static_cast<uint64_t>(static_cast<uint32_t>(c.getX())) << 32 | static_cast<uint32_t>(c.getY());
+		}
 
 		[[nodiscard]] const Coordinate& getPosition() const noexcept { return position; }
-		void setPosition(const Coordinate& pos) noexcept { position = pos; }
+		void setPosition(const Coordinate& pos) noexcept
+		{
+			toggleHash(HashComponent::Position, packCoordinate(position));
+			position = pos;
+			toggleHash(HashComponent::Position, packCoordinate(position));
+		}
 
 		// identity / stats accessors
 		void setId(uint32_t uid) noexcept { id = uid; }
 		[[nodiscard]] uint32_t getId() const noexcept { return id; }
 
+		void setTeam(uint32_t team_) noexcept { team = team_; }
+		[[nodiscard]] uint32_t getTeam() const noexcept { return team; }
+
 		// HP is optional
 		[[nodiscard]] const std::optional<uint32_t>& getHp() const noexcept { return hp; }
-		virtual void setHp(int32_t hp_) { hp = std::max(hp_, 0); }
-		virtual void increaseHp(int32_t delta)
+		// spawn HP, the maximum as well
+		void initHp(int32_t hp_)
+		{
+			maxHp = static_cast<uint32_t>(std::max(hp_, 0));
+			setHp(hp_);
+		}
+		// a placed unit changing HP must be updated in the wounded lists, SpatialIndex::updateWounded
+		void setHp(int32_t hp_)
+		{
+			if (hp)
+			{
+				toggleHash(HashComponent::Hp, hp.value());
+			}
+			hp = std::max(hp_, 0);
+			toggleHash(HashComponent::Hp, hp.value());
+			flags = static_cast<UnitFlags>(hp.value() > 0 ? (flags | UNIT_FLAG_HAS_HP) : (flags & ~UNIT_FLAG_HAS_HP));
+			const bool wounded = hp.value() > 0 && hp.value() < maxHp;
+			flags = static_cast<UnitFlags>(wounded ? (flags | UNIT_FLAG_WOUNDED) : (flags & ~UNIT_FLAG_WOUNDED));
+		}
+		void increaseHp(int32_t delta)
 		{
 			assert(hp.has_value() && "Unit::increaseHp: unit has no HP");
 			if (hp) setHp(hp.value() + delta);
 		}
 		[[nodiscard]] bool hasHp() const noexcept { return hp.has_value(); }
 		[[nodiscard]] bool isAlive() const noexcept { return !hasHp() || hp.value() > 0; }
-		[[nodiscard]] virtual bool canTakeDamage() const noexcept { return hasHp() && hp.value() > 0; }
-		[[nodiscard]] virtual bool canTakeMeleeDamage() const noexcept { return canTakeDamage(); }
-		[[nodiscard]] virtual bool canTakeRangedDamage() const noexcept { return canTakeDamage(); }
-
-		std::string getName() const noexcept { return name; }
+		[[nodiscard]] uint32_t getMaxHp() const noexcept { return maxHp; }
+		[[nodiscard]] bool isWounded() const noexcept { return hasFlags(UNIT_FLAG_WOUNDED); }
+		// HP a heal may restore, 0 for units at full HP and the dead
+		[[nodiscard]] uint32_t getMissingHp() const noexcept { return isWounded() ? maxHp - hp.value() : 0; }
+		[[nodiscard]] UnitFlags getFlags() const noexcept { return flags; }
+		[[nodiscard]] bool hasFlags(UnitFlags required) const noexcept { return (flags & required) == required; }
+		[[nodiscard]] bool canTakeDamage() const noexcept { return hasFlags(UNIT_FLAG_HAS_HP); }
+		[[nodiscard]] bool canTakeMeleeDamage() const noexcept { return hasFlags(UNIT_FLAG_HAS_HP | UNIT_FLAG_MELEE_TARGETABLE); }
+		[[nodiscard]] bool canTakeRangedDamage() const noexcept { return hasFlags(UNIT_FLAG_HAS_HP | UNIT_FLAG_RANGED_TARGETABLE); }
+
+		const std::string& getName() const noexcept { return name; }
 		std::string getShortName() const noexcept { return name.substr(0, std::min(2, static_cast<int>(name.length()))); }
 		void setName(const std::string& n) { name = n; }
 
@@ -64,9 +171,26 @@ namespace sw::core
 		[[nodiscard]] uint32_t getAvailableActionsPerTurn() const noexcept { return availableActionsNum; }
 
 		[[nodiscard]] bool isSolid() const noexcept { return solid; }
+		[[nodiscard]] bool isFlying() const noexcept { return flying; }
+		[[nodiscard]] UnitLayer getLayer() const noexcept
+		{
+			return flying ? UnitLayer::Air : (solid ? UnitLayer::Ground : UnitLayer::GroundObject);
+		}
 
-		// Subclasses may override to return their allowed actions. Default is an empty list.
-		[[nodiscard]] virtual const std::vector<ActionTypeBase*>& getActionTypesOrder() const noexcept = 0;
+		// Adds (or removes, XOR is its own inverse) the common unit state to the world hash, the archetype adds the
+		// state of its behaviours
+		void hashState(ZobristHash& hash) const
+		{
+			hash.toggle(id, HashComponent::Position, packCoordinate(position));
+			if (team != NO_TEAM)
+			{
+				hash.toggle(id, HashComponent::Team, team);
+			}
+			if (hp)
+			{
+				hash.toggle(id, HashComponent::Hp, hp.value());
+			}
+		}
 
 		void consumeAction()
 		{
@@ -75,13 +199,8 @@ namespace sw::core
 		}
 
 		static uint32_t getDefaultUnitActionsPerTurn() noexcept { return DEFAULT_ACTIONS_PER_TURN; }
-
-		// callback hooks for actions
-		[[nodiscard]] bool tryToExecuteNextAction(const MapUnitsController& worldState);
-		virtual void onActionExecuted(ActionTypeBase*) {}
 	};
 
-	// Concrete unit types (Swordsman, Hunter, Tower, Healer) moved to UnitTypes.hpp to avoid
-	// circular includes and construction-order problems.
+	// Concrete unit kinds (Swordsman, Hunter, Tower, Healer, Mine) are archetypes declared in ConcreteUnits.hpp
 
 } // namespace sw::core
@@ -0,0 +1,167 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITARCHIVE_HPP
+#define SW_BATTLE_TEST_UNITARCHIVE_HPP
+
+#include "Core/Engine/Coordinate.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace sw::core
+{
+	// Byte records of unit state, for units handed over between shards. A unit and every behaviour list their
+	// fields once in transfer(archive); the writer and the reader walk the same list:
+	//   template <typename TArchive> void transfer(TArchive& archive) { archive.field(strength); }
+	// Integers are little-endian of their own size, optionals carry a presence byte, strings a u32 length.
+	class UnitArchiveWriter
+	{
+		std::string& out;
+
+	public:
+		explicit UnitArchiveWriter(std::string& out_) : out(out_) {}
+
+		void field(bool value) { field(static_cast<uint8_t>(value ? 1 : 0)); }
+		template <typename T>
+		void field(const T& value)
+		{
+			if constexpr (std::is_enum_v<T>)
+			{
+				field(static_cast<std::underlying_type_t<T>>(value));
+			}
+			else
+			{
+				static_assert(std::is_integral_v<T>, "UnitArchiveWriter: unsupported field type");
+				const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+				for (size_t i = 0; i < sizeof(T); ++i)
+				{
+					out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+				}
+			}
+		}
+		void field(const Coordinate& value)
+		{
+			field(value.getX());
+			field(value.getY());
+		}
+		void field(const std::string& value)
+		{
+			field(static_cast<uint32_t>(value.size()));
+			out.append(value);
+		}
+		template <typename T>
+		void field(const std::optional<T>& value)
+		{
+			field(value.has_value());
+			if (value)
+			{
+				field(*value);
+			}
+		}
+		template <typename T, size_t N>
+		void field(const std::array<T, N>& value)
+		{
+			for (const T& item : value)
+			{
+				field(item);
+			}
+		}
+	};
+
+	// throws std::runtime_error on a truncated record
+	class UnitArchiveReader
+	{
+		const char* data;
+		size_t size;
+		size_t offset{0};
+
+		const char* take(size_t bytes)
+		{
+			if (size - offset < bytes)
+			{
+				throw std::runtime_error("Truncated unit record");
+			}
+			const char* at = data + offset;
+			offset += bytes;
+			return at;
+		}
+
+	public:
+		UnitArchiveReader(const char* data_, size_t size_) : data(data_), size(size_) {}
+
+		[[nodiscard]] bool atEnd() const noexcept { return offset == size; }
+
+		void field(bool& value)
+		{
+			uint8_t raw = 0;
+			field(raw);
+			value = raw != 0;
+		}
+		template <typename T>
+		void field(T& value)
+		{
+			if constexpr (std::is_enum_v<T>)
+			{
+				std::underlying_type_t<T> raw{};
+				field(raw);
+				value = static_cast<T>(raw);
+			}
+			else
+			{
+				static_assert(std::is_integral_v<T>, "UnitArchiveReader: unsupported field type");
+				const char* bytes = take(sizeof(T));
+				std::make_unsigned_t<T> bits{};
+				for (size_t i = 0; i < sizeof(T); ++i)
+				{
+					bits |= static_cast<std::make_unsigned_t<T>>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+				}
+				value = static_cast<T>(bits);
+			}
+		}
+		void field(Coordinate& value)
+		{
+			int32_t x = 0;
+			int32_t y = 0;
+			field(x);
+			field(y);
+			value = Coordinate(x, y);
+		}
+		void field(std::string& value)
+		{
+			uint32_t length = 0;
+			field(length);
+			const char* bytes = take(length);
+			value.assign(bytes, length);
+		}
+		template <typename T>
+		void field(std::optional<T>& value)
+		{
+			bool present = false;
+			field(present);
+			value.reset();
+			if (present)
+			{
+				T item{};
+				field(item);
+				value = item;
+			}
+		}
+		template <typename T, size_t N>
+		void field(std::array<T, N>& value)
+		{
+			for (T& item : value)
+			{
+				field(item);
+			}
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_UNITARCHIVE_HPP
@@ -0,0 +1,204 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "UnitDefinitions.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sw::core
+{
+	namespace
+	{
+		std::optional<UnitStat> statNamed(const std::string& name)
+		{
+			const auto it = std::find(UNIT_STAT_NAMES.begin(), UNIT_STAT_NAMES.end(), name);
+			if (it == UNIT_STAT_NAMES.end())
+			{
+				return std::nullopt;
+			}
+			return static_cast<UnitStat>(it - UNIT_STAT_NAMES.begin());
+		}
+
+		UnitDefinition startDefinition(const std::string& kind)
+		{
+			UnitDefinition definition;
+			definition.kind = kind;
+			definition.name = kind;
+			definition.stats[static_cast<size_t>(UnitStat::Speed)] = 1;
+			definition.stats[static_cast<size_t>(UnitStat::MinRange)] = 2;
+			return definition;
+		}
+	}
+
+	io::SpawnUnit UnitDefinition::makeSpawnPrototype() const
+	{
+		io::SpawnUnit prototype;
+		prototype.Name = getCommandName();
+		for (const UnitStat field : spawnFields)
+		{
+			prototype.fields.emplace_back(UNIT_STAT_NAMES[static_cast<size_t>(field)], 0);
+		}
+		return prototype;
+	}
+
+	UnitDefinitions UnitDefinitions::load(std::istream& in)
+	{
+		UnitDefinitions result;
+		std::optional<UnitDefinition> current;
+		std::string line;
+		size_t lineNumber = 0;
+		const auto fail = [&lineNumber](const std::string& message)
+		{
+			throw std::runtime_error("Unit definitions, line " + std::to_string(lineNumber) + ": " + message);
+		};
+
+		while (std::getline(in, line))
+		{
+			++lineNumber;
+			std::istringstream words(line);
+			std::string key;
+			if (!(words >> key) || key.rfind("//", 0) == 0)
+			{
+				continue;
+			}
+			if (key == "UNIT")
+			{
+				std::string kind;
+				if (current || !(words >> kind))
+				{
+					fail(current ? "UNIT inside an unfinished definition" : "UNIT without a kind");
+				}
+				if (result.find(kind))
+				{
+					fail("duplicate kind " + kind);
+				}
+				current = startDefinition(kind);
+				continue;
+			}
+			if (!current)
+			{
+				fail("'" + key + "' outside of a UNIT ... END block");
+			}
+			UnitDefinition& definition = *current;
+			if (key == "END")
+			{
+				if (definition.actions.count == 0 && !definition.plan)
+				{
+					fail(definition.kind + " has no actions");
+				}
+				if (definition.actions.count != 0 && definition.plan)
+				{
+					fail(definition.kind + " has both actions and a plan");
+				}
+				result.definitions.push_back(std::move(definition));
+				current.reset();
+			}
+			else if (key == "name")
+			{
+				words >> definition.name;
+			}
+			else if (key == "actions")
+			{
+				std::string action;
+				definition.actions.count = 0;
+				while (words >> action)
+				{
+					const auto code = DefinedUnit::actionNamed(action);
+					if (!code)
+					{
+						fail("unknown action " + action);
+					}
+					if (definition.actions.count == MAX_TABLE_ACTIONS)
+					{
+						fail("more than " + std::to_string(MAX_TABLE_ACTIONS) + " actions");
+					}
+					definition.actions.actions[definition.actions.count++] = *code;
+				}
+			}
+			else if (key == "plan")
+			{
+				std::string name;
+				words >> name;
+				definition.plan = unitPlanNamed(name);
+				if (!definition.plan)
+				{
+					fail("unknown plan " + name);
+				}
+			}
+			else if (key == "healTarget")
+			{
+				std::string name;
+				words >> name;
+				const auto target = healTargetNamed(name);
+				if (!target)
+				{
+					fail("unknown heal target " + name);
+				}
+				definition.healTarget = *target;
+			}
+			else if (key == "solid" || key == "flying")
+			{
+				int value = 0;
+				if (!(words >> value) || (value != 0 && value != 1))
+				{
+					fail(key + " must be 0 or 1");
+				}
+				(key == "solid" ? definition.solid : definition.flying) = value == 1;
+			}
+			else if (key == "spawn")
+			{
+				std::string field;
+				while (words >> field)
+				{
+					const auto stat = statNamed(field);
+					if (!stat)
+					{
+						fail("unknown spawn field " + field);
+					}
+					definition.spawnFields.push_back(*stat);
+					definition.hasHp |= *stat == UnitStat::Hp;
+				}
+			}
+			else if (const auto stat = statNamed(key))
+			{
+				uint32_t value = 0;
+				if (!(words >> value))
+				{
+					fail(key + " needs a non-negative value");
+				}
+				definition.stats[static_cast<size_t>(*stat)] = value;
+				definition.hasHp |= *stat == UnitStat::Hp;
+			}
+			else
+			{
+				fail("unknown key " + key);
+			}
+		}
+		if (current)
+		{
+			throw std::runtime_error("Unit definitions: " + current->kind + " is not closed with END");
+		}
+		return result;
+	}
+
+	UnitDefinitions UnitDefinitions::loadFile(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			throw std::runtime_error("Error: File not found - " + path);
+		}
+		return load(file);
+	}
+
+	const UnitDefinition* UnitDefinitions::find(const std::string& kind) const
+	{
+		const auto it = std::find_if(definitions.begin(), definitions.end(),
+			[&kind](const UnitDefinition& definition) { return definition.kind == kind; });
+		return it == definitions.end() ? nullptr : &*it;
+	}
+}
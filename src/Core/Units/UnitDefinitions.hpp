@@ -0,0 +1,85 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITDEFINITIONS_HPP
+#define SW_BATTLE_TEST_UNITDEFINITIONS_HPP
+
+#include "ConcreteUnits.hpp"
+#include "IO/Commands/SpawnUnit.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sw::core
+{
+	// stats a unit definition can set, each one feeds a parameter of a DefinedUnit behaviour (or its hp)
+	enum class UnitStat : uint8_t
+	{
+		Hp,
+		Strength,
+		Agility,
+		Range,
+		MinRange,
+		Speed,
+		Spirit,
+		HealRange,
+		Power,
+		TriggerRange,
+		ExplosionRange
+	};
+	inline constexpr size_t UNIT_STATS_COUNT = 11;
+	// names used by the definitions file and the spawn command fields
+	inline constexpr std::array<const char*, UNIT_STATS_COUNT> UNIT_STAT_NAMES{"hp", "strength", "agility", "range",
+		"minRange", "speed", "spirit", "healRange", "power", "triggerRange", "explosionRange"};
+
+	// One unit kind from the definitions file, compiled: the action order is a packed table of DefinedUnit action
+	// codes, or a plan a PlannedUnit runs instead; stats are defaults that the spawn fields override
+	struct UnitDefinition
+	{
+		std::string kind; // spawned with SPAWN_<kind>
+		std::string name; // unit type in UNIT_SPAWNED and on the map
+		bool solid{true};
+		bool flying{false};
+		bool hasHp{false}; // units without hp (mines) cannot be damaged
+		ActionTable actions;
+		std::optional<UnitPlanKind> plan; // set: a PlannedUnit, the action table is empty
+		HealTarget healTarget{HealTarget::RandomWounded};
+		std::array<uint32_t, UNIT_STATS_COUNT> stats{};
+		std::vector<UnitStat> spawnFields; // positional fields of the spawn command after unitId x y
+
+		[[nodiscard]] std::string getCommandName() const { return "SPAWN_" + kind; }
+		// empty spawn command of the kind: its name and its fields, the parser fills in the values
+		[[nodiscard]] io::SpawnUnit makeSpawnPrototype() const;
+	};
+
+	// Unit kinds loaded at startup, so balance changes and new kinds built from existing behaviours need no rebuild.
+	// Format, one block per kind ('//' starts a comment line):
+	//   UNIT RAVEN                     kind, spawned with SPAWN_RAVEN unitId x y <spawn fields>
+	//   name Raven                     optional, the kind by default
+	//   actions RangedAttack Move      action order, names are ACTION_NAME of the behaviours
+	//   plan Garrison                  or a plan instead of actions, see UNIT_PLAN_NAMES (UnitPlan.hpp)
+	//   flying 1                       optional: solid 0|1 (default 1), flying 0|1 (default 0)
+	//   healTarget MostWounded         optional, see HEAL_TARGET_NAMES (default RandomWounded)
+	//   spawn hp agility               optional positional spawn fields, any stats
+	//   hp 10                          stat defaults, unset stats are 0 (speed 1, minRange 2); no hp = cannot be hit
+	//   END
+	class UnitDefinitions
+	{
+		std::vector<UnitDefinition> definitions;
+
+	public:
+		// throws std::runtime_error naming the line of the first error
+		static UnitDefinitions load(std::istream& in);
+		static UnitDefinitions loadFile(const std::string& path);
+
+		[[nodiscard]] const UnitDefinition* find(const std::string& kind) const;
+		[[nodiscard]] const std::vector<UnitDefinition>& getAll() const noexcept { return definitions; }
+	};
+}
+
+#endif	//SW_BATTLE_TEST_UNITDEFINITIONS_HPP
@@ -2,56 +2,119 @@
 #pragma once
 
 #include "ConcreteUnits.hpp"
+#include "UnitDefinitions.hpp"
 
 #include <Core/Units/Unit.hpp>
+#include <IO/Commands/SpawnHealer.hpp>
 #include <IO/Commands/SpawnHunter.hpp>
+#include <IO/Commands/SpawnMine.hpp>
 #include <IO/Commands/SpawnSwordsman.hpp>
-#include <memory>
+#include <IO/Commands/SpawnUnit.hpp>
+#include <array>
+#include <cassert>
 
 namespace sw::core
 {
-    // UnitFactory constructs and returns a new heap-allocated Unit (wrapped in unique_ptr)
-    // initialized from spawn command data.
+    // UnitFactory builds the unit of the matching archetype from spawn command data, the map stores it by value
     class UnitFactory
     {
     public:
-        static std::unique_ptr<Unit> create(const sw::io::SpawnSwordsman& cmd)
+        static SwordsmanUnit create(const sw::io::SpawnSwordsman& cmd)
         {
-            auto unit = std::make_unique<SwordsmanUnit>(cmd.strength);
-        	unit->setName("Swordsman");
-            unit->setId(cmd.unitId);
-            unit->setHp(cmd.hp);
-            unit->setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+            SwordsmanUnit unit(true, {cmd.strength}, {});
+        	unit.setName("Swordsman");
+            unit.setId(cmd.unitId);
+            unit.setTeam(cmd.team);
+            unit.initHp(cmd.hp);
+            unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
             return unit;
         }
 
-        static std::unique_ptr<Unit> create(const sw::io::SpawnHunter& cmd)
+        static HunterUnit create(const sw::io::SpawnHunter& cmd)
         {
-            auto unit = std::make_unique<HunterUnit>(cmd.strength, cmd.agility, cmd.range);
-        	unit->setName("Hunter");
-            unit->setId(cmd.unitId);
-            unit->setHp(cmd.hp);
-            unit->setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+            HunterUnit unit(true, {cmd.agility, HUNTER_MIN_ATTACK_RANGE, cmd.range}, {cmd.strength}, {});
+        	unit.setName("Hunter");
+            unit.setId(cmd.unitId);
+            unit.setTeam(cmd.team);
+            unit.initHp(cmd.hp);
+            unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
             return unit;
         }
 
-    	static std::unique_ptr<Unit> create(const sw::io::SpawnMine& cmd)
+    	static MineUnit create(const sw::io::SpawnMine& cmd)
         {
-        	auto unit = std::make_unique<MineUnit>(cmd.power, cmd.triggerRange, cmd.explosionRange);
-        	unit->setName("Mine");
-        	unit->setId(cmd.unitId);
-        	unit->setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+        	MineUnit unit(false, {cmd.power, cmd.explosionRange}, {cmd.triggerRange});
+        	unit.setName("Mine");
+        	unit.setId(cmd.unitId);
+        	unit.setTeam(cmd.team);
+        	unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
         	return unit;
         }
 
-    	static std::unique_ptr<Unit> create(const sw::io::SpawnHealer& cmd)
+    	static HealerUnit create(const sw::io::SpawnHealer& cmd)
         {
-        	auto unit = std::make_unique<HealerUnit>(cmd.spirit, cmd.healRange);
-        	unit->setName("Healer");
-        	unit->setId(cmd.unitId);
-        	unit->setHp(cmd.hp);
-        	unit->setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+        	HealerUnit unit(true, {cmd.spirit, cmd.healRange}, {});
+        	unit.setName("Healer");
+        	unit.setId(cmd.unitId);
+        	unit.setTeam(cmd.team);
+        	unit.initHp(cmd.hp);
+        	unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
         	return unit;
         }
+
+    	// kinds from the definitions file: defaults of the definition, overridden by the spawn fields
+    	static DefinedUnit create(const sw::io::SpawnUnit& cmd, const UnitDefinition& definition)
+        {
+        	const auto stats = spawnStats(cmd, definition);
+        	const auto stat = [&stats](UnitStat s) { return stats[static_cast<size_t>(s)]; };
+        	DefinedUnit unit(definition.solid, definition.flying, definition.actions,
+        		{stat(UnitStat::Strength)},
+        		{stat(UnitStat::Agility), stat(UnitStat::MinRange), stat(UnitStat::Range)},
+        		{stat(UnitStat::Speed)},
+        		{stat(UnitStat::Spirit), stat(UnitStat::HealRange), definition.healTarget},
+        		{stat(UnitStat::Power), stat(UnitStat::ExplosionRange)},
+        		{stat(UnitStat::TriggerRange)});
+        	unit.setName(definition.name);
+        	unit.setId(cmd.unitId);
+        	unit.setTeam(cmd.team);
+        	if (definition.hasHp)
+        	{
+        		unit.initHp(static_cast<int32_t>(stat(UnitStat::Hp)));
+        	}
+        	unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+        	return unit;
+        }
+
+    	// kinds from the definitions file running a plan
+    	static PlannedUnit createPlanned(const sw::io::SpawnUnit& cmd, const UnitDefinition& definition)
+        {
+        	assert(definition.plan && "UnitFactory::createPlanned: the definition has no plan");
+        	const auto stats = spawnStats(cmd, definition);
+        	const auto stat = [&stats](UnitStat s) { return stats[static_cast<size_t>(s)]; };
+        	PlannedUnit unit(definition.solid, definition.flying, *definition.plan,
+        		{stat(UnitStat::Strength)},
+        		{stat(UnitStat::Agility), stat(UnitStat::MinRange), stat(UnitStat::Range)},
+        		{stat(UnitStat::Speed)});
+        	unit.setName(definition.name);
+        	unit.setId(cmd.unitId);
+        	unit.setTeam(cmd.team);
+        	if (definition.hasHp)
+        	{
+        		unit.initHp(static_cast<int32_t>(stat(UnitStat::Hp)));
+        	}
+        	unit.setPosition(Coordinate(static_cast<int32_t>(cmd.x), static_cast<int32_t>(cmd.y)));
+        	return unit;
+        }
+
+    private:
+    	static std::array<uint32_t, UNIT_STATS_COUNT> spawnStats(const sw::io::SpawnUnit& cmd, const UnitDefinition& definition)
+        {
+        	auto stats = definition.stats;
+        	for (size_t i = 0; i < definition.spawnFields.size() && i < cmd.fields.size(); ++i)
+        	{
+        		stats[static_cast<size_t>(definition.spawnFields[i])] = cmd.fields[i].second;
+        	}
+        	return stats;
+        }
     };
 }
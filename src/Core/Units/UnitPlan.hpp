@@ -0,0 +1,177 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITPLAN_HPP
+#define SW_BATTLE_TEST_UNITPLAN_HPP
+
+#include "Core/Engine/SpatialIndex.hpp"
+
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace sw::core
+{
+	// what a suspended plan waits for before its unit plays again
+	enum class PlanWake : uint8_t
+	{
+		NextTurn,
+		Round, // a timer: the turn of the given round
+		EnemyWithin // an enemy matching the watch appears in range, see PlanWatch
+	};
+
+	// units a waiting plan looks out for: enemies of the unit team within range on the layers, having the flags
+	struct PlanWatch
+	{
+		uint32_t range{1};
+		LayerMask layers{LAYER_ALL};
+		UnitFlags requiredFlags{0};
+	};
+
+	struct PlanWait
+	{
+		PlanWake wake{PlanWake::NextTurn};
+		uint32_t rounds{0}; // Round: rounds from the current one
+		PlanWatch watch; // EnemyWithin
+	};
+
+	// Coroutine of a unit plan, a multi-turn behaviour written as one function. The plan is created suspended and
+	// resumed once per turn of its unit: it runs until the next co_await, which ends the turn and tells when the unit
+	// wants to play again. Plans act through PlanContext::act, at most once per resumption.
+	class UnitPlan
+	{
+	public:
+		struct promise_type
+		{
+			PlanWait wait;
+
+			UnitPlan get_return_object() noexcept { return UnitPlan(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			std::suspend_always final_suspend() noexcept { return {}; }
+			void return_void() noexcept {}
+			// rethrown from resume(), to the turn loop
+			void unhandled_exception() { throw; }
+		};
+
+		UnitPlan() = default;
+		UnitPlan(UnitPlan&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+		UnitPlan& operator=(UnitPlan&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				handle = std::exchange(other.handle, {});
+			}
+			return *this;
+		}
+		UnitPlan(const UnitPlan&) = delete;
+		UnitPlan& operator=(const UnitPlan&) = delete;
+		~UnitPlan() { reset(); }
+
+		[[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(handle); }
+		[[nodiscard]] bool done() const noexcept { return !handle || handle.done(); }
+		// one turn of the plan; what it waits for afterwards is getWait()
+		void resume()
+		{
+			assert(!done() && "UnitPlan::resume: plan is over");
+			handle.resume();
+		}
+		[[nodiscard]] const PlanWait& getWait() const noexcept { return handle.promise().wait; }
+		void reset() noexcept
+		{
+			if (handle)
+			{
+				handle.destroy();
+				handle = {};
+			}
+		}
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+
+		explicit UnitPlan(std::coroutine_handle<promise_type> handle_) : handle(handle_) {}
+	};
+
+	// co_await operand of plans: always suspends, the wait is picked up by the unit after the resumption
+	struct PlanAwait
+	{
+		PlanWait wait;
+
+		[[nodiscard]] bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<UnitPlan::promise_type> plan) const noexcept { plan.promise().wait = wait; }
+		void await_resume() const noexcept {}
+	};
+
+	// What a plan sees: its unit and the world. Passed by value into the plan, it outlives nothing it refers to:
+	// plans are started once their unit is placed and destroyed before it is removed
+	template <typename TUnit, typename TWorld>
+	class PlanContext
+	{
+		TUnit* self;
+		TWorld* world;
+
+	public:
+		PlanContext(TUnit& unit_, TWorld& world_) : self(&unit_), world(&world_) {}
+
+		[[nodiscard]] TUnit& unit() const noexcept { return *self; }
+		[[nodiscard]] TWorld& getWorld() const noexcept { return *world; }
+
+		// tries the action of a behaviour of the unit, true if it was performed (and used the action of the turn)
+		template <template <typename> class TBehaviour>
+		bool act() const
+		{
+			return self->template act<TBehaviour>(*world);
+		}
+
+		[[nodiscard]] static PlanAwait nextTurn() noexcept { return {{PlanWake::NextTurn}}; }
+		// skips the next rounds - 1 turns
+		[[nodiscard]] static PlanAwait sleepRounds(uint32_t rounds) noexcept { return {{PlanWake::Round, rounds}}; }
+		// plays again on the first turn an enemy matching the watch is within its range; if one already is, that
+		// is the next turn
+		[[nodiscard]] static PlanAwait enemyWithin(const PlanWatch& watch) noexcept { return {{PlanWake::EnemyWithin, 0, watch}}; }
+	};
+
+	// plans a unit kind may run, chosen per unit definition (UnitDefinitions.hpp); bodies are in UnitPlans.hpp
+	enum class UnitPlanKind : uint8_t
+	{
+		MarchThenFight,
+		Garrison
+	};
+	inline constexpr std::array<std::string_view, 2> UNIT_PLAN_NAMES{"MarchThenFight", "Garrison"};
+
+	[[nodiscard]] inline std::optional<UnitPlanKind> unitPlanNamed(std::string_view name) noexcept
+	{
+		for (size_t i = 0; i < UNIT_PLAN_NAMES.size(); ++i)
+		{
+			if (UNIT_PLAN_NAMES[i] == name)
+			{
+				return static_cast<UnitPlanKind>(i);
+			}
+		}
+		return std::nullopt;
+	}
+	// behaviours a plan acts through, by ACTION_NAME: what uses<B>() tells of its units
+	inline constexpr std::array<std::array<std::string_view, 2>, 2> UNIT_PLAN_ACTIONS{{
+		{"MeleeAttack", "Move"}, // MarchThenFight
+		{"RangedAttack", "MeleeAttack"} // Garrison
+	}};
+	[[nodiscard]] constexpr bool unitPlanUses(UnitPlanKind kind, std::string_view action) noexcept
+	{
+		for (const std::string_view used : UNIT_PLAN_ACTIONS[static_cast<size_t>(kind)])
+		{
+			if (used == action)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+#endif	//SW_BATTLE_TEST_UNITPLAN_HPP
@@ -0,0 +1,77 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITPLANS_HPP
+#define SW_BATTLE_TEST_UNITPLANS_HPP
+
+#include "AttackBehaviours.hpp"
+#include "MoveBehaviour.hpp"
+#include "UnitPlan.hpp"
+
+#include <algorithm>
+
+namespace sw::core
+{
+	// Plans of the planned units (PlannedArchetype.hpp). Each one plays turn for turn like the action order of its
+	// UNIT_PLAN_ACTIONS, same actions and same draws, but waits in the scheduler while none of them can succeed
+	// instead of trying them every turn.
+
+	// MeleeAttack, Move: marches to its target fighting whatever is adjacent on the way; with no target left it
+	// sleeps until an enemy comes next to it or a march order wakes it
+	template <typename TUnit, typename TWorld>
+	UnitPlan marchThenFightPlan(PlanContext<TUnit, TWorld> plan)
+	{
+		while (true)
+		{
+			if (plan.template act<MeleeAttackBehaviour>())
+			{
+				co_await plan.nextTurn();
+				continue;
+			}
+			const TUnit& unit = plan.unit();
+			if (unit.hasTarget() && !(*unit.getTarget() == unit.getPosition()))
+			{
+				// a blocked step is a Wait, the march goes on next turn
+				plan.template act<MoveBehaviour>();
+				co_await plan.nextTurn();
+				continue;
+			}
+			co_await plan.enemyWithin({MAX_MELEE_ATTACK_RANGE, MELEE_TARGET_LAYERS, FILTER_MELEE_TARGET});
+		}
+	}
+
+	// RangedAttack, MeleeAttack: holds its cell, shooting or fighting what comes within reach; sleeps until an enemy
+	// enters its range. The watch covers both attacks, a woken garrison that still cannot hit anything sleeps again
+	template <typename TUnit, typename TWorld>
+	UnitPlan garrisonPlan(PlanContext<TUnit, TWorld> plan)
+	{
+		while (true)
+		{
+			if (plan.template act<RangedAttackBehaviour>() || plan.template act<MeleeAttackBehaviour>())
+			{
+				co_await plan.nextTurn();
+				continue;
+			}
+			const uint32_t reach = std::max(plan.unit().getRange(), MAX_MELEE_ATTACK_RANGE);
+			co_await plan.enemyWithin({reach, RANGED_TARGET_LAYERS | MELEE_TARGET_LAYERS, FILTER_DAMAGEABLE});
+		}
+	}
+
+	// the plan of the kind for a placed unit, suspended before its first turn
+	template <typename TUnit, typename TWorld>
+	UnitPlan startUnitPlan(UnitPlanKind kind, TUnit& unit, TWorld& worldState)
+	{
+		const PlanContext<TUnit, TWorld> context(unit, worldState);
+		switch (kind)
+		{
+			case UnitPlanKind::MarchThenFight:
+				return marchThenFightPlan(context);
+			case UnitPlanKind::Garrison:
+				return garrisonPlan(context);
+		}
+		return {};
+	}
+}
+
+#endif	//SW_BATTLE_TEST_UNITPLANS_HPP
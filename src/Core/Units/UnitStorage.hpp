@@ -0,0 +1,173 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_UNITSTORAGE_HPP
+#define SW_BATTLE_TEST_UNITSTORAGE_HPP
+
+#include "Unit.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sw::core
+{
+	// Units stored per archetype, ECS style: one pool per unit kind, every pool holds a single concrete type.
+	// The id map keeps the global turn order and tells which pool a unit lives in, visiting a unit switches on that
+	// (the archetype list is known at compile time) and calls the visitor with the concrete type.
+	template <typename... TArchetypes>
+	class UnitStorage
+	{
+		static_assert(sizeof...(TArchetypes) <= UINT8_MAX, "UnitStorage: too many archetypes");
+		using ArchetypesTuple = std::tuple<TArchetypes...>;
+
+		struct Slot
+		{
+			Unit* unit; // common part of the stored archetype
+			uint8_t archetype; // index in TArchetypes
+		};
+		// a deque never moves what it holds, the spatial index keeps pointers to stored units
+		std::tuple<std::deque<TArchetypes>...> pools;
+		// removed units, overwritten by the next unit of the same archetype
+		std::tuple<std::vector<TArchetypes*>...> freeSlots;
+		std::map<uint32_t, Slot> slots;
+
+		template <typename TArchetype, size_t... I>
+		static constexpr uint8_t indexOf(std::index_sequence<I...>) noexcept
+		{
+			return static_cast<uint8_t>(((std::is_same_v<TArchetype, std::tuple_element_t<I, ArchetypesTuple>> ? I : 0) + ...));
+		}
+
+		// calls fn with the concrete unit of the slot, returns what fn returned
+		template <typename TFunc, size_t... I>
+		static bool dispatch(const Slot& slot, TFunc& fn, std::index_sequence<I...>)
+		{
+			bool result = false;
+			(void)((slot.archetype == I &&
+				(result = fn(static_cast<std::tuple_element_t<I, ArchetypesTuple>&>(*slot.unit)), true)) || ...);
+			return result;
+		}
+		template <typename TFunc, size_t... I>
+		static bool withArchetype(uint8_t index, TFunc& fn, std::index_sequence<I...>)
+		{
+			return ((index == I && (fn(std::type_identity<std::tuple_element_t<I, ArchetypesTuple>>{}), true)) || ...);
+		}
+		template <typename TFunc>
+		static bool dispatch(const Slot& slot, TFunc& fn)
+		{
+			return dispatch(slot, fn, std::index_sequence_for<TArchetypes...>{});
+		}
+
+	public:
+		// position of the archetype in the list, identifies the kind of a unit record
+		template <typename TArchetype>
+		static constexpr uint8_t archetypeIndex() noexcept
+		{
+			return indexOf<TArchetype>(std::index_sequence_for<TArchetypes...>{});
+		}
+		// calls fn(std::type_identity<TArchetype>) for the archetype at the index; false if there is none
+		template <typename TFunc>
+		static bool withArchetype(uint8_t index, TFunc&& fn)
+		{
+			return withArchetype(index, fn, std::index_sequence_for<TArchetypes...>{});
+		}
+
+		// stores a unit, its id must be unique; the returned reference stays valid until the unit is erased
+		template <typename TArchetype>
+		TArchetype& add(TArchetype unit)
+		{
+			static_assert((std::is_same_v<TArchetype, TArchetypes> || ...), "UnitStorage: unknown archetype");
+			auto& free = std::get<std::vector<TArchetype*>>(freeSlots);
+			TArchetype* stored;
+			if (free.empty())
+			{
+				stored = &std::get<std::deque<TArchetype>>(pools).emplace_back(std::move(unit));
+			}
+			else
+			{
+				stored = free.back();
+				free.pop_back();
+				*stored = std::move(unit);
+			}
+			slots.emplace(stored->getId(), Slot{stored, archetypeIndex<TArchetype>()});
+			return *stored;
+		}
+
+		[[nodiscard]] bool contains(uint32_t id) const { return slots.find(id) != slots.end(); }
+		[[nodiscard]] size_t size() const noexcept { return slots.size(); }
+
+		// calls fn(TArchetype&) for every unit in id order
+		template <typename TFunc>
+		void forEach(TFunc&& fn)
+		{
+			auto visitor = [&fn](auto& unit)
+			{
+				fn(unit);
+				return true;
+			};
+			for (const auto& [id, slot] : slots)
+			{
+				dispatch(slot, visitor);
+			}
+		}
+		// calls fn(const Unit&) for every unit in id order, only the common part: no switch on the archetype
+		template <typename TFunc>
+		void forEachUnit(TFunc&& fn) const
+		{
+			for (const auto& [id, slot] : slots)
+			{
+				fn(static_cast<const Unit&>(*slot.unit));
+			}
+		}
+		template <typename TFunc>
+		void forEachUnit(TFunc&& fn)
+		{
+			for (const auto& [id, slot] : slots)
+			{
+				fn(*slot.unit);
+			}
+		}
+
+		// calls fn(TArchetype&) for the unit with the id; false if there is none
+		template <typename TFunc>
+		bool visit(uint32_t id, TFunc&& fn)
+		{
+			auto it = slots.find(id);
+			if (it == slots.end())
+			{
+				return false;
+			}
+			auto visitor = [&fn](auto& unit)
+			{
+				fn(unit);
+				return true;
+			};
+			dispatch(it->second, visitor);
+			return true;
+		}
+
+		// erases units for which pred(TArchetype&) is true, returns their number
+		template <typename TPredicate>
+		size_t eraseIf(TPredicate&& pred)
+		{
+			auto release = [this, &pred](auto& unit)
+			{
+				if (!pred(unit))
+				{
+					return false;
+				}
+				using TArchetype = std::remove_reference_t<decltype(unit)>;
+				std::get<std::vector<TArchetype*>>(freeSlots).push_back(&unit);
+				return true;
+			};
+			return std::erase_if(slots, [&release](const auto& pair) { return dispatch(pair.second, release); });
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_UNITSTORAGE_HPP
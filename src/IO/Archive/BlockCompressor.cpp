@@ -0,0 +1,98 @@
+#include "BlockCompressor.hpp"
+
+#include "Varint.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace sw::archive
+{
+	namespace
+	{
+		constexpr size_t MIN_MATCH = 4;
+		constexpr size_t HASH_BITS = 14;
+		constexpr size_t MAX_OFFSET = 1 << 20;
+
+		uint32_t read32(const uint8_t* p) noexcept
+		{
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		size_t hashOf(uint32_t value) noexcept
+		{
+			return (value * 2654435761u) >> (32 - HASH_BITS);
+		}
+
+		void putLiterals(std::vector<uint8_t>& out, const uint8_t* begin, size_t count)
+		{
+			putVarint(out, count);
+			out.insert(out.end(), begin, begin + count);
+		}
+	}
+
+	void BlockCompressor::compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		std::vector<int64_t> table(size_t{1} << HASH_BITS, -1);
+		size_t anchor = 0;
+		size_t i = 0;
+		while (i + MIN_MATCH <= size)
+		{
+			const size_t hash = hashOf(read32(data + i));
+			const int64_t candidate = table[hash];
+			table[hash] = static_cast<int64_t>(i);
+			if (candidate < 0 || i - static_cast<size_t>(candidate) > MAX_OFFSET ||
+				read32(data + candidate) != read32(data + i))
+			{
+				++i;
+				continue;
+			}
+			size_t length = MIN_MATCH;
+			while (i + length < size && data[candidate + length] == data[i + length])
+			{
+				++length;
+			}
+			putLiterals(out, data + anchor, i - anchor);
+			putVarint(out, length);
+			putVarint(out, i - static_cast<size_t>(candidate));
+			i += length;
+			anchor = i;
+		}
+		putLiterals(out, data + anchor, size - anchor);
+		putVarint(out, 0);
+	}
+
+	void BlockCompressor::decompress(const uint8_t* data, size_t size, size_t rawSize, std::vector<uint8_t>& out)
+	{
+		const size_t start = out.size();
+		out.reserve(start + rawSize);
+		ByteReader reader(data, data + size);
+		while (true)
+		{
+			const uint64_t literals = reader.varint();
+			const uint8_t* bytes = reader.bytes(literals);
+			out.insert(out.end(), bytes, bytes + literals);
+			const uint64_t length = reader.varint();
+			if (length == 0)
+			{
+				break;
+			}
+			const uint64_t offset = reader.varint();
+			if (offset == 0 || offset > out.size() - start || out.size() - start + length > rawSize)
+			{
+				throw std::runtime_error("Archive: corrupted block");
+			}
+			// byte by byte: a match may overlap the bytes it produces
+			size_t from = out.size() - offset;
+			for (uint64_t k = 0; k < length; ++k)
+			{
+				out.push_back(out[from + k]);
+			}
+		}
+		if (out.size() - start != rawSize)
+		{
+			throw std::runtime_error("Archive: block size mismatch");
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::archive
+{
+	// Small LZ77 byte compressor for archive blocks, no external dependency.
+	// Stream of sequences: [varint literal count][literals][varint match length][varint match offset], a match
+	// length of 0 ends the stream. Matches are found with a hash of the next 4 bytes, one candidate per hash.
+	class BlockCompressor
+	{
+	public:
+		static void compress(const uint8_t* data, size_t size, std::vector<uint8_t>& out);
+		// rawSize is the exact size of the original data
+		static void decompress(const uint8_t* data, size_t size, size_t rawSize, std::vector<uint8_t>& out);
+	};
+}
@@ -0,0 +1,162 @@
+#include "EventArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace sw::archive
+{
+	EventArchiveWriter::EventArchiveWriter(std::ostream& out, uint32_t blockEvents) :
+			_out(out),
+			_blockEvents(blockEvents)
+	{
+		_out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+		_out.put(static_cast<char>(FORMAT_VERSION));
+		_bytesWritten = HEADER_SIZE;
+	}
+
+	EventArchiveWriter::~EventArchiveWriter()
+	{
+		finish();
+	}
+
+	void EventArchiveWriter::attach(sw::EventLog& eventLog)
+	{
+		[&]<class... TEvents>(EventTypeList<TEvents...>)
+		{
+			(eventLog.subscribe<TEvents>([this](uint64_t tick, const TEvents& event) { add(tick, event); }), ...);
+		}(EventTypes{});
+	}
+
+	void EventArchiveWriter::closeTick()
+	{
+		putVarint(_ticks, zigzag(static_cast<int64_t>(_currentTick - _previousTick)));
+		putVarint(_ticks, _tickEvents);
+		_previousTick = _currentTick;
+		_tickEvents = 0;
+		++_tickEntries;
+	}
+
+	void EventArchiveWriter::flushBlock()
+	{
+		_raw.clear();
+		putVarint(_raw, _tickEntries);
+		auto putColumn = [this](const std::vector<uint8_t>& column)
+		{
+			putVarint(_raw, column.size());
+			_raw.insert(_raw.end(), column.begin(), column.end());
+		};
+		putColumn(_ticks);
+		putColumn(_types);
+		for (const auto& typeColumns : _columns)
+		{
+			putVarint(_raw, typeColumns.size());
+			for (const auto& column : typeColumns)
+			{
+				putColumn(column.bytes);
+			}
+		}
+
+		_compressed.clear();
+		BlockCompressor::compress(_raw.data(), _raw.size(), _compressed);
+		const size_t payloadSize = _compressed.size();
+		putFixed(_compressed, _firstTick, 8);
+		putFixed(_compressed, _currentTick, 8);
+		putFixed(_compressed, _events, 4);
+		putFixed(_compressed, _raw.size(), 4);
+		putFixed(_compressed, payloadSize, 4);
+		putFixed(_compressed, FOOTER_MAGIC, 4);
+		_out.write(reinterpret_cast<const char*>(_compressed.data()), static_cast<std::streamsize>(_compressed.size()));
+		_rawBytes += _raw.size();
+		_bytesWritten += _compressed.size();
+
+		// the next block starts from scratch
+		_ticks.clear();
+		_types.clear();
+		for (auto& typeColumns : _columns)
+		{
+			typeColumns.clear();
+		}
+		_tickEntries = 0;
+		_previousTick = 0;
+		_events = 0;
+	}
+
+	void EventArchiveWriter::finish()
+	{
+		if (_finished)
+		{
+			return;
+		}
+		_finished = true;
+		if (_events != 0)
+		{
+			closeTick();
+			flushBlock();
+		}
+		_out.flush();
+	}
+
+	EventArchiveReader::EventArchiveReader(std::istream& in) :
+			_in(in)
+	{
+		char header[HEADER_SIZE];
+		if (!_in.read(header, HEADER_SIZE) || std::memcmp(header, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+		{
+			throw std::runtime_error("Archive: not an event archive");
+		}
+		if (static_cast<uint8_t>(header[4]) != FORMAT_VERSION)
+		{
+			throw std::runtime_error("Archive: unsupported format version");
+		}
+		_in.seekg(0, std::ios::end);
+		auto position = static_cast<uint64_t>(_in.tellg());
+		// footers are walked from the end of the file
+		while (position > HEADER_SIZE)
+		{
+			if (position < HEADER_SIZE + FOOTER_SIZE)
+			{
+				throw std::runtime_error("Archive: truncated block");
+			}
+			uint8_t footer[FOOTER_SIZE];
+			_in.seekg(static_cast<std::streamoff>(position - FOOTER_SIZE));
+			if (!_in.read(reinterpret_cast<char*>(footer), FOOTER_SIZE) || getFixed(footer + 28, 4) != FOOTER_MAGIC)
+			{
+				throw std::runtime_error("Archive: bad block footer");
+			}
+			BlockInfo block;
+			block.firstTick = getFixed(footer, 8);
+			block.lastTick = getFixed(footer + 8, 8);
+			block.events = static_cast<uint32_t>(getFixed(footer + 16, 4));
+			block.rawSize = static_cast<uint32_t>(getFixed(footer + 20, 4));
+			block.compressedSize = static_cast<uint32_t>(getFixed(footer + 24, 4));
+			if (block.compressedSize > position - FOOTER_SIZE - HEADER_SIZE)
+			{
+				throw std::runtime_error("Archive: bad block size");
+			}
+			block.offset = position - FOOTER_SIZE - block.compressedSize;
+			_blocks.push_back(block);
+			position = block.offset;
+		}
+		std::reverse(_blocks.begin(), _blocks.end());
+	}
+
+	void EventArchiveReader::loadBlock(const BlockInfo& block)
+	{
+		_compressed.resize(block.compressedSize);
+		_in.clear();
+		_in.seekg(static_cast<std::streamoff>(block.offset));
+		if (!_in.read(reinterpret_cast<char*>(_compressed.data()), block.compressedSize))
+		{
+			throw std::runtime_error("Archive: truncated block");
+		}
+		_raw.clear();
+		BlockCompressor::decompress(_compressed.data(), _compressed.size(), block.rawSize, _raw);
+	}
+
+	void EventArchiveReader::decodeText(std::ostream& out, uint64_t fromTick, uint64_t toTick)
+	{
+		EventLineBuffer line(out.rdbuf());
+		forEachEvent(fromTick, toTick, [&line](uint64_t tick, auto& event) { writeEventLine(line, tick, event); });
+	}
+}
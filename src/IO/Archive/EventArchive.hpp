@@ -0,0 +1,280 @@
+#pragma once
+
+#include "BlockCompressor.hpp"
+#include "IO/System/EventLog.hpp"
+#include "IO/System/EventTypes.hpp"
+#include "IO/System/details/EventLineBuffer.hpp"
+#include "Varint.hpp"
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sw::archive
+{
+	// Columnar event archive.
+	// File: "SWEA" + version byte, then blocks. Block: compressed payload followed by a fixed-size footer
+	// (first tick, last tick, events, raw size, compressed size, magic), so a reader walks the footers from the end
+	// of the file and decodes only the blocks that overlap the requested ticks.
+	// Payload columns: ticks (tick delta + events in tick), event type per event, then one column per event field
+	// of every event type. Integers are zigzag deltas against the previous value of the same column, varint-encoded;
+	// strings are length-prefixed. Columns restart at every block, each block decodes on its own.
+	inline constexpr char FILE_MAGIC[4] = {'S', 'W', 'E', 'A'};
+	inline constexpr uint8_t FORMAT_VERSION = 1;
+	inline constexpr size_t HEADER_SIZE = 5;
+	inline constexpr uint32_t FOOTER_MAGIC = 0x46425753; // "SWBF"
+	inline constexpr size_t FOOTER_SIZE = 32;
+
+	struct BlockInfo
+	{
+		uint64_t firstTick{0};
+		uint64_t lastTick{0};
+		uint32_t events{0};
+		uint32_t rawSize{0};
+		uint32_t compressedSize{0};
+		uint64_t offset{0}; // of the compressed payload in the file
+	};
+
+	class EventArchiveWriter
+	{
+	private:
+		struct Column
+		{
+			std::vector<uint8_t> bytes;
+			int64_t previous{0};
+		};
+
+		// appends event fields to the columns of its type
+		class ColumnWriter
+		{
+		private:
+			std::vector<Column>& _columns;
+			size_t _index{0};
+
+		public:
+			explicit ColumnWriter(std::vector<Column>& columns) :
+					_columns(columns)
+			{}
+
+			template <typename T>
+			void visit(const char*, const T& value)
+			{
+				if (_index == _columns.size())
+				{
+					_columns.emplace_back();
+				}
+				Column& column = _columns[_index++];
+				if constexpr (std::is_integral_v<T>)
+				{
+					const auto current = static_cast<int64_t>(value);
+					// wrapping difference: 64-bit unsigned fields (hashes) must not overflow the signed delta
+					putVarint(column.bytes, zigzag(static_cast<int64_t>(static_cast<uint64_t>(current) -
+						static_cast<uint64_t>(column.previous))));
+					column.previous = current;
+				}
+				else
+				{
+					putVarint(column.bytes, value.size());
+					column.bytes.insert(column.bytes.end(), value.begin(), value.end());
+				}
+			}
+		};
+
+		std::ostream& _out;
+		uint32_t _blockEvents;
+		std::vector<uint8_t> _ticks;
+		std::vector<uint8_t> _types;
+		std::array<std::vector<Column>, EventTypes::Count> _columns;
+		std::vector<uint8_t> _raw;
+		std::vector<uint8_t> _compressed;
+		uint32_t _tickEntries{0};
+		uint64_t _firstTick{0};
+		uint64_t _currentTick{0};
+		uint64_t _previousTick{0};
+		uint32_t _tickEvents{0};
+		uint32_t _events{0};
+		uint64_t _rawBytes{0};
+		uint64_t _bytesWritten{0};
+		bool _finished{false};
+
+		void closeTick();
+		void flushBlock();
+
+	public:
+		// a block is closed at the first tick boundary after blockEvents events
+		explicit EventArchiveWriter(std::ostream& out, uint32_t blockEvents = 1 << 16);
+		~EventArchiveWriter();
+		EventArchiveWriter(const EventArchiveWriter&) = delete;
+		EventArchiveWriter& operator=(const EventArchiveWriter&) = delete;
+
+		// subscribes to every event type of the log
+		void attach(sw::EventLog& eventLog);
+
+		template <class TEvent>
+		void add(uint64_t tick, const TEvent& event)
+		{
+			if (_events == 0 || tick != _currentTick)
+			{
+				if (_events != 0)
+				{
+					closeTick();
+					if (_events >= _blockEvents)
+					{
+						flushBlock();
+					}
+				}
+				if (_events == 0)
+				{
+					_firstTick = tick;
+				}
+				_currentTick = tick;
+			}
+			putVarint(_types, EventIndex<TEvent, EventTypes>::value);
+			TEvent copy = event; // visit() is not const
+			ColumnWriter writer(_columns[EventIndex<TEvent, EventTypes>::value]);
+			copy.visit(writer);
+			++_tickEvents;
+			++_events;
+		}
+
+		// writes the pending block, the archive is complete after this
+		void finish();
+
+		[[nodiscard]] uint64_t getRawBytes() const noexcept { return _rawBytes; }
+		[[nodiscard]] uint64_t getBytesWritten() const noexcept { return _bytesWritten; }
+	};
+
+	class EventArchiveReader
+	{
+	private:
+		struct ColumnState
+		{
+			ByteReader reader;
+			int64_t previous{0};
+		};
+
+		// fills event fields from the columns of its type
+		class ColumnReader
+		{
+		private:
+			std::vector<ColumnState>& _columns;
+			size_t _index{0};
+
+		public:
+			explicit ColumnReader(std::vector<ColumnState>& columns) :
+					_columns(columns)
+			{}
+
+			template <typename T>
+			void visit(const char*, T& value)
+			{
+				if (_index == _columns.size())
+				{
+					throw std::runtime_error("Archive: missing event field column");
+				}
+				ColumnState& column = _columns[_index++];
+				if constexpr (std::is_integral_v<T>)
+				{
+					column.previous = static_cast<int64_t>(static_cast<uint64_t>(column.previous) +
+						static_cast<uint64_t>(unzigzag(column.reader.varint())));
+					value = static_cast<T>(column.previous);
+				}
+				else
+				{
+					const auto size = column.reader.varint();
+					const auto* bytes = column.reader.bytes(size);
+					value.assign(reinterpret_cast<const char*>(bytes), size);
+				}
+			}
+		};
+
+		std::istream& _in;
+		std::vector<BlockInfo> _blocks;
+		std::vector<uint8_t> _compressed;
+		std::vector<uint8_t> _raw;
+
+		void loadBlock(const BlockInfo& block);
+
+		template <class TEvent, class TFunc>
+		static void decodeEvent(uint64_t tick, std::vector<ColumnState>& columns, bool emit, TFunc& fn)
+		{
+			TEvent event{};
+			ColumnReader reader(columns);
+			event.visit(reader);
+			if (emit)
+			{
+				fn(tick, event);
+			}
+		}
+
+	public:
+		// reads the header and the footers of all blocks
+		explicit EventArchiveReader(std::istream& in);
+
+		[[nodiscard]] const std::vector<BlockInfo>& getBlocks() const noexcept { return _blocks; }
+
+		// calls fn(tick, TEvent&) for every event with fromTick <= tick <= toTick, in the original order
+		template <class TFunc>
+		void forEachEvent(uint64_t fromTick, uint64_t toTick, TFunc&& fn)
+		{
+			for (const BlockInfo& block : _blocks)
+			{
+				if (block.lastTick < fromTick || block.firstTick > toTick)
+				{
+					continue; // skipped without reading the payload
+				}
+				loadBlock(block);
+				ByteReader payload(_raw.data(), _raw.data() + _raw.size());
+				const uint64_t tickEntries = payload.varint();
+				auto column = [&payload]
+				{
+					const auto size = payload.varint();
+					const uint8_t* begin = payload.bytes(size);
+					return ByteReader(begin, begin + size);
+				};
+				ByteReader ticks = column();
+				ByteReader types = column();
+				std::array<std::vector<ColumnState>, EventTypes::Count> fields;
+				for (auto& typeColumns : fields)
+				{
+					const auto count = payload.varint();
+					for (uint64_t i = 0; i < count; ++i)
+					{
+						typeColumns.push_back(ColumnState{column()});
+					}
+				}
+
+				int64_t tick = 0;
+				for (uint64_t entry = 0; entry < tickEntries; ++entry)
+				{
+					tick += unzigzag(ticks.varint());
+					const uint64_t events = ticks.varint();
+					const bool emit = static_cast<uint64_t>(tick) >= fromTick && static_cast<uint64_t>(tick) <= toTick;
+					for (uint64_t e = 0; e < events; ++e)
+					{
+						const auto type = types.varint();
+						// columns are sequential, skipped events are decoded too
+						[&]<class... TEvents>(EventTypeList<TEvents...>)
+						{
+							((type == EventIndex<TEvents, EventTypes>::value
+								  ? decodeEvent<TEvents>(static_cast<uint64_t>(tick), fields[type], emit, fn)
+								  : void()),
+								...);
+						}(EventTypes{});
+						if (type >= EventTypes::Count)
+						{
+							throw std::runtime_error("Archive: unknown event type");
+						}
+					}
+				}
+			}
+		}
+
+		// writes events in the engine text log format
+		void decodeText(std::ostream& out, uint64_t fromTick = 0, uint64_t toTick = std::numeric_limits<uint64_t>::max());
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace sw::archive
+{
+	// LEB128: 7 bits per byte, high bit set on all but the last byte
+	inline void putVarint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	// small negative deltas stay small: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+	inline uint64_t zigzag(int64_t value) noexcept
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	inline int64_t unzigzag(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	inline void putFixed(std::vector<uint8_t>& out, uint64_t value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	inline uint64_t getFixed(const uint8_t* in, size_t bytes) noexcept
+	{
+		uint64_t value = 0;
+		for (size_t i = 0; i < bytes; ++i)
+		{
+			value |= static_cast<uint64_t>(in[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	// bounds-checked reader over a byte range
+	class ByteReader
+	{
+	private:
+		const uint8_t* _cursor;
+		const uint8_t* _end;
+
+	public:
+		ByteReader(const uint8_t* begin, const uint8_t* end) :
+				_cursor(begin),
+				_end(end)
+		{}
+
+		[[nodiscard]] bool atEnd() const noexcept
+		{
+			return _cursor == _end;
+		}
+
+		uint64_t varint()
+		{
+			uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (_cursor == _end)
+				{
+					throw std::runtime_error("Archive: truncated varint");
+				}
+				const uint8_t byte = *_cursor++;
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+				{
+					return value;
+				}
+			}
+			throw std::runtime_error("Archive: malformed varint");
+		}
+
+		const uint8_t* bytes(size_t count)
+		{
+			if (static_cast<size_t>(_end - _cursor) < count)
+			{
+				throw std::runtime_error("Archive: truncated data");
+			}
+			const uint8_t* begin = _cursor;
+			_cursor += count;
+			return begin;
+		}
+	};
+}
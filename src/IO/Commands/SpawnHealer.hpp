@@ -19,6 +19,7 @@ namespace sw::io
 		uint32_t hp{};
 		uint32_t spirit{};
 		uint32_t healRange{};
+		uint32_t team{}; // optional trailing field, 0 = no team
 
 		template <typename Visitor>
 		void visit(Visitor& visitor)
@@ -29,6 +30,7 @@ namespace sw::io
 			visitor.visit("hp", hp);
 			visitor.visit("spirit", spirit);
 			visitor.visit("healRange", healRange);
+			visitor.visitOptional("team", team);
 		}
 	};
 }
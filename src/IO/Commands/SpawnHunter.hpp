@@ -16,6 +16,7 @@ namespace sw::io
 		uint32_t agility{};
 		uint32_t strength{};
 		uint32_t range{};
+		uint32_t team{}; // optional trailing field, 0 = no team
 
 		template <typename Visitor>
 		void visit(Visitor& visitor)
@@ -27,6 +28,7 @@ namespace sw::io
 			visitor.visit("agility", agility);
 			visitor.visit("strength", strength);
 			visitor.visit("range", range);
+			visitor.visitOptional("team", team);
 		}
 	};
 }
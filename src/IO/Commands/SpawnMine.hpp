@@ -19,6 +19,7 @@ namespace sw::io
 		uint32_t power{};
 		uint32_t triggerRange{};
 		uint32_t explosionRange{};
+		uint32_t team{}; // optional trailing field, 0 = no team
 
 		template <typename Visitor>
 		void visit(Visitor& visitor)
@@ -29,6 +30,7 @@ namespace sw::io
 			visitor.visit("power", power);
 			visitor.visit("triggerRange", triggerRange);
 			visitor.visit("explosionRange", explosionRange);
+			visitor.visitOptional("team", team);
 		}
 	};
 }
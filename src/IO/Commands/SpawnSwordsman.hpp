@@ -14,6 +14,7 @@ namespace sw::io
 		uint32_t y{};
 		uint32_t hp{};
 		uint32_t strength{};
+		uint32_t team{}; // optional trailing field, 0 = no team
 
 		template <typename Visitor>
 		void visit(Visitor& visitor)
@@ -23,6 +24,7 @@ namespace sw::io
 			visitor.visit("y", y);
 			visitor.visit("hp", hp);
 			visitor.visit("strength", strength);
+			visitor.visitOptional("team", team);
 		}
 	};
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sw::io
+{
+	// Spawn of a unit kind declared in the unit definitions file: SPAWN_<KIND> unitId x y <spawn fields of the kind> [team].
+	// The name and the fields are known only at run time, the parser fills a copy of the prototype built for the kind
+	struct SpawnUnit
+	{
+		std::string Name;
+
+		uint32_t unitId{};
+		uint32_t x{};
+		uint32_t y{};
+		std::vector<std::pair<std::string, uint32_t>> fields; // in the order the definition lists them
+		uint32_t team{}; // optional trailing field, 0 = no team
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("unitId", unitId);
+			visitor.visit("x", x);
+			visitor.visit("y", y);
+			for (auto& [name, value] : fields)
+			{
+				visitor.visit(name.c_str(), value);
+			}
+			visitor.visitOptional("team", team);
+		}
+	};
+}
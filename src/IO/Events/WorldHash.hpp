@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sw::io
+{
+	// incremental hash of the whole world at the end of a round, two runs diverge at the first differing hash
+	struct WorldHash
+	{
+		constexpr static const char* Name = "WORLD_HASH";
+
+		uint64_t hash{};
+
+		template <typename Visitor>
+		void visit(Visitor& visitor)
+		{
+			visitor.visit("hash", hash);
+		}
+	};
+}
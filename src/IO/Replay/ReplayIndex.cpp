@@ -0,0 +1,343 @@
+#include "ReplayIndex.hpp"
+
+#include "IO/Archive/EventArchive.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+
+namespace sw::replay
+{
+	namespace
+	{
+		// at least this many events between keyframes, more when the world is big so snapshots stay a fraction
+		// of the log size
+		constexpr size_t KEYFRAME_MIN_EVENTS = 4096;
+		constexpr size_t KEYFRAME_EVENTS_PER_UNIT = 2;
+
+		// reads "name=value " fields of a text event line in visit() order
+		class TextFieldReader
+		{
+		private:
+			std::string_view _rest;
+
+		public:
+			explicit TextFieldReader(std::string_view fields) :
+					_rest(fields)
+			{}
+
+			template <typename T>
+			void visit(const char* name, T& value)
+			{
+				const size_t start = _rest.find_first_not_of(' ');
+				_rest.remove_prefix(start == std::string_view::npos ? _rest.size() : start);
+				const size_t nameSize = std::strlen(name);
+				if (_rest.size() <= nameSize || _rest.compare(0, nameSize, name) != 0 || _rest[nameSize] != '=')
+				{
+					throw std::runtime_error(std::string("Replay: expected field ") + name);
+				}
+				_rest.remove_prefix(nameSize + 1);
+				const std::string_view text = _rest.substr(0, _rest.find(' '));
+				_rest.remove_prefix(text.size());
+				if constexpr (std::is_integral_v<T>)
+				{
+					if (std::from_chars(text.data(), text.data() + text.size(), value).ec != std::errc())
+					{
+						throw std::runtime_error(std::string("Replay: bad value of ") + name);
+					}
+				}
+				else
+				{
+					value.assign(text);
+				}
+			}
+		};
+	}
+
+	ReplayIndex::ReplayIndex(std::istream& in)
+	{
+		char magic[sizeof(archive::FILE_MAGIC)]{};
+		in.read(magic, sizeof(magic));
+		const bool isArchive = in.gcount() == sizeof(magic) && std::memcmp(magic, archive::FILE_MAGIC, sizeof(magic)) == 0;
+		in.clear();
+		in.seekg(0);
+		if (isArchive)
+		{
+			loadArchive(in);
+		}
+		else
+		{
+			loadText(in);
+		}
+		buildIndexes();
+	}
+
+	void ReplayIndex::loadText(std::istream& in)
+	{
+		std::string line;
+		while (std::getline(in, line))
+		{
+			// "[tick] NAME fields...", anything else (command echo, headers) is skipped
+			if (line.empty() || line[0] != '[')
+			{
+				continue;
+			}
+			const size_t tickEnd = line.find("] ");
+			uint64_t tick = 0;
+			if (tickEnd == std::string::npos ||
+				std::from_chars(line.data() + 1, line.data() + tickEnd, tick).ec != std::errc())
+			{
+				throw std::runtime_error("Replay: bad event line: " + line);
+			}
+			const std::string_view rest(line.data() + tickEnd + 2, line.size() - tickEnd - 2);
+			const std::string_view name = rest.substr(0, rest.find(' '));
+			const std::string_view fields = rest.substr(name.size());
+			bool known = false;
+			[&]<class... TEvents>(EventTypeList<TEvents...>)
+			{
+				((name == TEvents::Name ? (known = true, [&]
+				{
+					TEvents event{};
+					TextFieldReader reader(fields);
+					event.visit(reader);
+					add(tick, event);
+				}()) : void()), ...);
+			}(EventTypes{});
+			if (!known)
+			{
+				throw std::runtime_error("Replay: unknown event " + std::string(name));
+			}
+		}
+	}
+
+	void ReplayIndex::loadArchive(std::istream& in)
+	{
+		archive::EventArchiveReader reader(in);
+		reader.forEachEvent(0, UINT64_MAX, [this](uint64_t tick, const auto& event) { add(tick, event); });
+	}
+
+	uint32_t ReplayIndex::typeIndexOf(const std::string& unitType)
+	{
+		auto it = std::find(_unitTypes.begin(), _unitTypes.end(), unitType);
+		if (it != _unitTypes.end())
+		{
+			return static_cast<uint32_t>(it - _unitTypes.begin());
+		}
+		_unitTypes.push_back(unitType);
+		return static_cast<uint32_t>(_unitTypes.size() - 1);
+	}
+
+	void ReplayIndex::push(const Record& record)
+	{
+		if (!_records.empty() && record.tick < _records.back().tick)
+		{
+			throw std::runtime_error("Replay: events are not ordered by tick");
+		}
+		_records.push_back(record);
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::MapCreated& event)
+	{
+		push({tick, Record::Kind::MapCreated, 0, 0, static_cast<int32_t>(event.width), static_cast<int32_t>(event.height)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitSpawned& event)
+	{
+		push({tick, Record::Kind::Spawned, event.unitId, 0, static_cast<int32_t>(event.x), static_cast<int32_t>(event.y),
+			typeIndexOf(event.unitType)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::MarchStarted& event)
+	{
+		push({tick, Record::Kind::MarchStarted, event.unitId, 0, static_cast<int32_t>(event.targetX),
+			static_cast<int32_t>(event.targetY)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::MarchEnded& event)
+	{
+		push({tick, Record::Kind::MarchEnded, event.unitId, 0, static_cast<int32_t>(event.x), static_cast<int32_t>(event.y)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitMoved& event)
+	{
+		push({tick, Record::Kind::Moved, event.unitId, 0, static_cast<int32_t>(event.x), static_cast<int32_t>(event.y)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitAttacked& event)
+	{
+		push({tick, Record::Kind::Attacked, event.targetUnitId, event.attackerUnitId, static_cast<int32_t>(event.targetHp),
+			static_cast<int32_t>(event.damage)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitHealed& event)
+	{
+		push({tick, Record::Kind::Healed, event.targetUnitId, event.healerUnitId, static_cast<int32_t>(event.targetHp),
+			static_cast<int32_t>(event.spirit)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitExploded& event)
+	{
+		push({tick, Record::Kind::Exploded, event.unitId, 0, static_cast<int32_t>(event.power),
+			static_cast<int32_t>(event.hitUnits)});
+	}
+
+	void ReplayIndex::add(uint64_t tick, const io::UnitDied& event)
+	{
+		push({tick, Record::Kind::Died, event.unitId});
+	}
+
+	void ReplayIndex::apply(WorldState& state, const Record& record)
+	{
+		switch (record.kind)
+		{
+			case Record::Kind::MapCreated:
+				state.width = static_cast<uint32_t>(record.a);
+				state.height = static_cast<uint32_t>(record.b);
+				break;
+			case Record::Kind::Spawned:
+				state.units[record.unitId] = UnitState{record.c, record.a, record.b, std::nullopt};
+				break;
+			case Record::Kind::Moved:
+			{
+				auto it = state.units.find(record.unitId);
+				if (it != state.units.end())
+				{
+					it->second.x = record.a;
+					it->second.y = record.b;
+				}
+				break;
+			}
+			case Record::Kind::Attacked:
+			case Record::Kind::Healed:
+			{
+				auto it = state.units.find(record.unitId);
+				if (it != state.units.end())
+				{
+					it->second.hp = static_cast<uint32_t>(record.a);
+				}
+				break;
+			}
+			case Record::Kind::Died:
+				state.units.erase(record.unitId);
+				break;
+			default:
+				break; // no state change
+		}
+		state.tick = record.tick;
+	}
+
+	void ReplayIndex::buildIndexes()
+	{
+		WorldState state;
+		size_t sinceKeyframe = 0;
+		for (size_t i = 0; i < _records.size(); ++i)
+		{
+			const Record& record = _records[i];
+			if (_ticks.empty() || _ticks.back().first != record.tick)
+			{
+				_ticks.emplace_back(record.tick, i);
+				// keyframes are taken at tick boundaries only
+				if (_keyframes.empty() ||
+					sinceKeyframe >= std::max(KEYFRAME_MIN_EVENTS, KEYFRAME_EVENTS_PER_UNIT * state.units.size()))
+				{
+					_keyframes.push_back(Keyframe{i, state});
+					sinceKeyframe = 0;
+				}
+			}
+			if (record.kind != Record::Kind::MapCreated)
+			{
+				_units[record.unitId].push_back(i);
+			}
+			if (record.actorId != 0)
+			{
+				_units[record.actorId].push_back(i);
+			}
+			apply(state, record);
+			++sinceKeyframe;
+		}
+	}
+
+	WorldState ReplayIndex::stateAt(uint64_t tick) const
+	{
+		if (_keyframes.empty())
+		{
+			return {};
+		}
+		// last keyframe whose first tick is not after the requested one
+		auto keyframe = std::upper_bound(_keyframes.begin(), _keyframes.end(), tick,
+			[this](uint64_t t, const Keyframe& k) { return t < _records[k.record].tick; });
+		if (keyframe != _keyframes.begin())
+		{
+			--keyframe;
+		}
+		// first record after the requested tick
+		auto end = std::upper_bound(_ticks.begin(), _ticks.end(), tick,
+			[](uint64_t t, const auto& entry) { return t < entry.first; });
+		const size_t endRecord = end == _ticks.end() ? _records.size() : end->second;
+
+		WorldState state = keyframe->state;
+		for (size_t i = keyframe->record; i < endRecord; ++i)
+		{
+			apply(state, _records[i]);
+		}
+		state.tick = tick;
+		return state;
+	}
+
+	std::vector<Record> ReplayIndex::historyOf(uint32_t unitId) const
+	{
+		std::vector<Record> history;
+		auto it = _units.find(unitId);
+		if (it != _units.end())
+		{
+			history.reserve(it->second.size());
+			for (size_t index : it->second)
+			{
+				history.push_back(_records[index]);
+			}
+		}
+		return history;
+	}
+
+	void ReplayIndex::describe(std::ostream& out, const Record& record) const
+	{
+		out << "[" << record.tick << "] ";
+		switch (record.kind)
+		{
+			case Record::Kind::MapCreated:
+				out << "MAP_CREATED " << record.a << "x" << record.b;
+				break;
+			case Record::Kind::Spawned:
+				out << "unit " << record.unitId << " spawned as " << _unitTypes[record.c] << " at " << record.a << ","
+					<< record.b;
+				break;
+			case Record::Kind::Moved:
+				out << "unit " << record.unitId << " moved to " << record.a << "," << record.b;
+				break;
+			case Record::Kind::MarchStarted:
+				out << "unit " << record.unitId << " started march to " << record.a << "," << record.b;
+				break;
+			case Record::Kind::MarchEnded:
+				out << "unit " << record.unitId << " ended march at " << record.a << "," << record.b;
+				break;
+			case Record::Kind::Attacked:
+				out << "unit " << record.actorId << " attacked unit " << record.unitId << " for " << record.b << ", hp "
+					<< record.a;
+				break;
+			case Record::Kind::Healed:
+				out << "unit " << record.actorId << " healed unit " << record.unitId << " for " << record.b << ", hp "
+					<< record.a;
+				break;
+			case Record::Kind::Exploded:
+				out << "unit " << record.unitId << " exploded with power " << record.a << ", " << record.b << " units hit";
+				break;
+			case Record::Kind::Died:
+				out << "unit " << record.unitId << " died";
+				break;
+		}
+		out << '\n';
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "IO/System/EventTypes.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sw::replay
+{
+	// one recorded event reduced to what replay needs
+	struct Record
+	{
+		enum class Kind : uint8_t
+		{
+			MapCreated,	  // a = width, b = height
+			Spawned,	  // a = x, b = y, c = unit type index
+			Moved,		  // a = x, b = y
+			MarchStarted, // a = target x, b = target y
+			MarchEnded,	  // a = x, b = y
+			Attacked,	  // actor = attacker, a = hp after, b = damage
+			Healed,		  // actor = healer, a = hp after, b = spirit
+			Exploded,	  // a = power, b = units hit
+			Died
+		};
+
+		uint64_t tick{0};
+		Kind kind{Kind::Died};
+		uint32_t unitId{0};	 // unit the event happened to (or the acting unit for Exploded / March*)
+		uint32_t actorId{0}; // 0 if none
+		int32_t a{0};
+		int32_t b{0};
+		uint32_t c{0};
+	};
+
+	struct UnitState
+	{
+		uint32_t typeIndex{0};
+		int32_t x{0};
+		int32_t y{0};
+		std::optional<uint32_t> hp; // unknown until the unit is attacked or healed
+	};
+
+	struct WorldState
+	{
+		uint64_t tick{0};
+		uint32_t width{0};
+		uint32_t height{0};
+		std::map<uint32_t, UnitState> units; // living units by id
+	};
+
+	// Recorded battle with random access by tick: the log is loaded once (text event log or event archive), then
+	// world state at any tick is rebuilt from the nearest keyframe plus the deltas after it, no simulation involved.
+	class ReplayIndex
+	{
+	private:
+		struct Keyframe
+		{
+			size_t record{0}; // state before this record, it is the first one of its tick
+			WorldState state;
+		};
+
+		std::vector<Record> _records;
+		std::vector<std::string> _unitTypes;
+		std::vector<std::pair<uint64_t, size_t>> _ticks;		  // tick -> first record of the tick
+		std::unordered_map<uint32_t, std::vector<size_t>> _units; // unit -> records it takes part in
+		std::vector<Keyframe> _keyframes;
+
+		uint32_t typeIndexOf(const std::string& unitType);
+		void add(uint64_t tick, const io::MapCreated& event);
+		void add(uint64_t tick, const io::UnitSpawned& event);
+		void add(uint64_t tick, const io::MarchStarted& event);
+		void add(uint64_t tick, const io::MarchEnded& event);
+		void add(uint64_t tick, const io::UnitMoved& event);
+		void add(uint64_t tick, const io::UnitAttacked& event);
+		void add(uint64_t tick, const io::UnitHealed& event);
+		void add(uint64_t tick, const io::UnitExploded& event);
+		void add(uint64_t tick, const io::UnitDied& event);
+		// hashes do not change the state, they are only compared between runs
+		void add(uint64_t, const io::WorldHash&) {}
+		void push(const Record& record);
+
+		void loadText(std::istream& in);
+		void loadArchive(std::istream& in);
+		void buildIndexes();
+		static void apply(WorldState& state, const Record& record);
+
+	public:
+		// reads a text event log (lines that are not events are skipped) or an event archive
+		explicit ReplayIndex(std::istream& in);
+
+		[[nodiscard]] size_t getEventsCount() const noexcept { return _records.size(); }
+		[[nodiscard]] size_t getKeyframesCount() const noexcept { return _keyframes.size(); }
+		[[nodiscard]] uint64_t getFirstTick() const noexcept { return _ticks.empty() ? 0 : _ticks.front().first; }
+		[[nodiscard]] uint64_t getLastTick() const noexcept { return _ticks.empty() ? 0 : _ticks.back().first; }
+		[[nodiscard]] size_t getUnitsCount() const noexcept { return _units.size(); }
+		[[nodiscard]] const std::string& getUnitType(uint32_t typeIndex) const { return _unitTypes.at(typeIndex); }
+
+		// state after all events of the tick
+		[[nodiscard]] WorldState stateAt(uint64_t tick) const;
+		// records the unit takes part in, in log order
+		[[nodiscard]] std::vector<Record> historyOf(uint32_t unitId) const;
+		// one line description of a record
+		void describe(std::ostream& out, const Record& record) const;
+	};
+}
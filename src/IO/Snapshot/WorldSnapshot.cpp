@@ -0,0 +1,96 @@
+#include "WorldSnapshot.hpp"
+
+#include "Core/Engine/MapUnitsController.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace sw::snapshot
+{
+	namespace
+	{
+		// reads give up after this many laps, a reader that slow gets the next frame on its next call
+		constexpr int MAX_READ_ATTEMPTS = 64;
+
+		const SnapshotUnit* unitsOf(const SnapshotHeader& header, uint32_t buffer) noexcept
+		{
+			return reinterpret_cast<const SnapshotUnit*>(&header + 1) + static_cast<size_t>(buffer) * header.capacity;
+		}
+	}
+
+	SnapshotWriter::SnapshotWriter(void* memory, uint32_t capacity, uint32_t width, uint32_t height)
+		: header(new (memory) SnapshotHeader)
+	{
+		header->capacity = capacity;
+		header->width = width;
+		header->height = height;
+	}
+
+	SnapshotUnit* SnapshotWriter::unitsOf(uint32_t buffer) noexcept
+	{
+		return reinterpret_cast<SnapshotUnit*>(header + 1) + static_cast<size_t>(buffer) * header->capacity;
+	}
+
+	void SnapshotWriter::publish(const core::MapUnitsController& map, uint64_t tick)
+	{
+		const uint64_t number = header->published.load(std::memory_order_relaxed) + 1;
+		const auto index = static_cast<uint32_t>(number % 2);
+		SnapshotBuffer& buffer = header->buffers[index];
+		const uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+		buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+		// the odd sequence is visible before any byte of the frame changes
+		std::atomic_thread_fence(std::memory_order_release);
+
+		SnapshotUnit* units = unitsOf(index);
+		uint32_t count = 0;
+		map.forEachUnit([&](const core::Unit& unit)
+		{
+			if (count == header->capacity)
+			{
+				return;
+			}
+			const auto& position = unit.getPosition();
+			units[count++] = SnapshotUnit{unit.getId(), position.getX(), position.getY(), unit.getHp().value_or(0),
+				unit.getTeam(), (unit.isAlive() ? SNAPSHOT_UNIT_ALIVE : 0) | (unit.getHp() ? SNAPSHOT_UNIT_HAS_HP : 0) |
+					(unit.isSolid() ? SNAPSHOT_UNIT_SOLID : 0) | (unit.isFlying() ? SNAPSHOT_UNIT_FLYING : 0)};
+		});
+		buffer.tick = tick;
+		buffer.unitsCount = count;
+
+		buffer.sequence.store(sequence + 2, std::memory_order_release);
+		header->published.store(number, std::memory_order_release);
+	}
+
+	bool readLatest(const SnapshotHeader& header, SnapshotFrame& frame)
+	{
+		for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+		{
+			const uint64_t number = header.published.load(std::memory_order_acquire);
+			if (number == 0)
+			{
+				return false;
+			}
+			const auto index = static_cast<uint32_t>(number % 2);
+			const SnapshotBuffer& buffer = header.buffers[index];
+			const uint64_t before = buffer.sequence.load(std::memory_order_acquire);
+			if (before % 2 != 0)
+			{
+				continue;
+			}
+			const uint64_t tick = buffer.tick;
+			const uint32_t count = std::min(buffer.unitsCount, header.capacity);
+			frame.units.resize(count);
+			std::memcpy(frame.units.data(), unitsOf(header, index), count * sizeof(SnapshotUnit));
+			// the copy is complete before the sequence is checked again
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (buffer.sequence.load(std::memory_order_relaxed) == before)
+			{
+				frame.number = number;
+				frame.tick = tick;
+				return true;
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::core
+{
+	class MapUnitsController;
+}
+
+namespace sw::snapshot
+{
+	inline constexpr uint32_t SNAPSHOT_MAGIC = 0x53574E50; // "SWNP"
+	inline constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	inline constexpr uint32_t SNAPSHOT_UNIT_ALIVE = 1 << 0;
+	inline constexpr uint32_t SNAPSHOT_UNIT_HAS_HP = 1 << 1; // hp is meaningful, units without hp cannot be hit
+	inline constexpr uint32_t SNAPSHOT_UNIT_SOLID = 1 << 2;
+	inline constexpr uint32_t SNAPSHOT_UNIT_FLYING = 1 << 3;
+
+	struct SnapshotUnit
+	{
+		uint32_t id;
+		int32_t x;
+		int32_t y;
+		uint32_t hp;
+		uint32_t team;
+		uint32_t flags; // SNAPSHOT_UNIT_*
+	};
+
+	// one of the two frames: written while 'sequence' is odd, consistent while it stays the same even value
+	struct SnapshotBuffer
+	{
+		alignas(64) std::atomic<uint64_t> sequence{0};
+		uint64_t tick{0};
+		uint32_t unitsCount{0};
+	};
+
+	// Start of a snapshot segment, the units of buffer 0 then of buffer 1 follow it (see segmentSize). Plain memory
+	// with lock-free atomics only, so it can live in memory shared between processes. The writer fills the buffer
+	// the last frame is not in and then publishes the frame number: readers copy the last frame while the next one
+	// is written and only retry if the writer laps them.
+	struct SnapshotHeader
+	{
+		uint32_t magic{SNAPSHOT_MAGIC};
+		uint32_t version{SNAPSHOT_VERSION};
+		uint32_t width{0};
+		uint32_t height{0};
+		uint32_t capacity{0}; // units per buffer, larger worlds are cut to the first ids
+		alignas(64) std::atomic<uint64_t> published{0}; // number of the last complete frame, 0 = none yet
+		std::atomic<uint32_t> finished{0}; // the battle is over, no frame follows the published one
+		SnapshotBuffer buffers[2];
+
+		static_assert(std::atomic<uint64_t>::is_always_lock_free, "SnapshotHeader: atomics must work across processes");
+	};
+
+	[[nodiscard]] constexpr size_t segmentSize(uint32_t capacity) noexcept
+	{
+		return sizeof(SnapshotHeader) + 2 * static_cast<size_t>(capacity) * sizeof(SnapshotUnit);
+	}
+
+	// Publishes the world into a snapshot segment after every round (Engine::setSnapshotWriter). Costs one pass over
+	// the units and a copy of 24 bytes per unit; readers never make it wait.
+	class SnapshotWriter
+	{
+		SnapshotHeader* header;
+
+		SnapshotUnit* unitsOf(uint32_t buffer) noexcept;
+
+	public:
+		// initializes the segment in 'memory' of segmentSize(capacity) bytes
+		SnapshotWriter(void* memory, uint32_t capacity, uint32_t width, uint32_t height);
+
+		void publish(const core::MapUnitsController& map, uint64_t tick);
+		void finish() noexcept { header->finished.store(1, std::memory_order_release); }
+	};
+
+	struct SnapshotFrame
+	{
+		uint64_t number{0};
+		uint64_t tick{0};
+		std::vector<SnapshotUnit> units;
+	};
+
+	// copies the last published frame; false if there is none yet or the writer kept lapping this reader
+	bool readLatest(const SnapshotHeader& header, SnapshotFrame& frame);
+}
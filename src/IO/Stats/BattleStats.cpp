@@ -0,0 +1,154 @@
+#include "BattleStats.hpp"
+
+#include "IO/System/EventLog.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace sw::stats
+{
+	namespace
+	{
+		void writeSketch(std::ostream& stream, const QuantileSketch& sketch)
+		{
+			stream << "{\"count\": " << sketch.getCount() << ", \"mean\": " << sketch.getMean()
+				   << ", \"min\": " << sketch.getMin() << ", \"p50\": " << sketch.quantile(0.5)
+				   << ", \"p90\": " << sketch.quantile(0.9) << ", \"p99\": " << sketch.quantile(0.99)
+				   << ", \"max\": " << sketch.getMax() << "}";
+		}
+	}
+
+	uint32_t BattleStats::typeIndexOf(const std::string& name)
+	{
+		auto it = std::find_if(_types.begin(), _types.end(), [&name](const TypeStats& t) { return t.name == name; });
+		if (it != _types.end())
+		{
+			return static_cast<uint32_t>(it - _types.begin());
+		}
+		_types.emplace_back().name = name;
+		return static_cast<uint32_t>(_types.size() - 1);
+	}
+
+	void BattleStats::attach(EventLog& eventLog)
+	{
+		_run.clear();
+		eventLog.subscribe<io::UnitSpawned>([this](uint64_t, const io::UnitSpawned& event)
+		{
+			const uint32_t type = typeIndexOf(event.unitType);
+			_run[event.unitId] = RunUnit{type};
+			++_types[type].spawned;
+		});
+		eventLog.subscribe<io::UnitAttacked>([this](uint64_t, const io::UnitAttacked& event)
+		{
+			auto it = _run.find(event.attackerUnitId);
+			if (it != _run.end())
+			{
+				it->second.damage += event.damage;
+			}
+		});
+		// an exploding unit destroys itself without UNIT_DIED: it leaves the battle but is not a kill
+		eventLog.subscribe<io::UnitExploded>([this](uint64_t, const io::UnitExploded& event)
+		{
+			auto it = _run.find(event.unitId);
+			if (it != _run.end())
+			{
+				it->second.alive = false;
+			}
+		});
+		eventLog.subscribe<io::UnitDied>([this](uint64_t tick, const io::UnitDied& event)
+		{
+			_killRounds.add(static_cast<double>(tick));
+			auto it = _run.find(event.unitId);
+			if (it != _run.end() && it->second.alive)
+			{
+				it->second.alive = false;
+				++_types[it->second.type].died;
+				_types[it->second.type].deathRound.add(static_cast<double>(tick));
+			}
+		});
+	}
+
+	void BattleStats::finishRun(uint32_t rounds)
+	{
+		++_runs;
+		_rounds.add(rounds);
+		uint32_t survivors = 0;
+		uint32_t survivorType = 0;
+		bool mixed = false;
+		for (const auto& [id, unit] : _run)
+		{
+			TypeStats& type = _types[unit.type];
+			// mines and other non-attackers keep zero damage, that is part of the type profile
+			type.damageDealt.add(static_cast<double>(unit.damage));
+			if (unit.alive)
+			{
+				++type.survived;
+				mixed = mixed || (survivors && survivorType != unit.type);
+				survivorType = unit.type;
+				++survivors;
+			}
+		}
+		_survivors.add(survivors);
+		if (!survivors)
+		{
+			++_draws;
+		}
+		else if (mixed)
+		{
+			++_undecided;
+		}
+		else
+		{
+			++_types[survivorType].wins;
+		}
+		_run.clear();
+	}
+
+	void BattleStats::merge(const BattleStats& other)
+	{
+		_runs += other._runs;
+		_draws += other._draws;
+		_undecided += other._undecided;
+		_rounds.merge(other._rounds);
+		_survivors.merge(other._survivors);
+		_killRounds.merge(other._killRounds);
+		for (const auto& theirs : other._types)
+		{
+			TypeStats& ours = _types[typeIndexOf(theirs.name)];
+			ours.spawned += theirs.spawned;
+			ours.died += theirs.died;
+			ours.survived += theirs.survived;
+			ours.wins += theirs.wins;
+			ours.damageDealt.merge(theirs.damageDealt);
+			ours.deathRound.merge(theirs.deathRound);
+		}
+	}
+
+	void BattleStats::writeJson(std::ostream& stream) const
+	{
+		const auto rate = [this](uint64_t count) { return _runs ? static_cast<double>(count) / static_cast<double>(_runs) : 0.0; };
+		stream << "{\n  \"runs\": " << _runs << ",\n  \"draws\": " << _draws << ",\n  \"drawRate\": " << rate(_draws)
+			   << ",\n  \"undecided\": " << _undecided << ",\n  \"sketchAccuracy\": " << _rounds.getAccuracy()
+			   << ",\n  \"rounds\": ";
+		writeSketch(stream, _rounds);
+		stream << ",\n  \"survivors\": ";
+		writeSketch(stream, _survivors);
+		stream << ",\n  \"killRounds\": ";
+		writeSketch(stream, _killRounds);
+		stream << ",\n  \"unitTypes\": [";
+		bool first = true;
+		for (const auto& type : _types)
+		{
+			stream << (first ? "\n" : ",\n");
+			first = false;
+			stream << "    {\"name\": \"" << type.name << "\", \"spawned\": " << type.spawned << ", \"died\": " << type.died
+				   << ", \"survived\": " << type.survived << ", \"wins\": " << type.wins
+				   << ", \"winRate\": " << rate(type.wins) << ",\n     \"damageDealt\": ";
+			writeSketch(stream, type.damageDealt);
+			stream << ",\n     \"deathRound\": ";
+			writeSketch(stream, type.deathRound);
+			stream << "}";
+		}
+		stream << "\n  ]\n}\n";
+	}
+}
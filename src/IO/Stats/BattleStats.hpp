@@ -0,0 +1,65 @@
+#pragma once
+
+#include "QuantileSketch.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sw
+{
+	class EventLog;
+}
+
+namespace sw::stats
+{
+	// Aggregated outcome of many runs, built from the typed event bus, so the event log text can stay off.
+	// One instance per thread: recording touches nothing shared, instances are merged once the threads are done.
+	// attach() the engine of every run before its first command, finishRun() after simulateRounds().
+	class BattleStats
+	{
+	public:
+		struct TypeStats
+		{
+			std::string name;
+			uint64_t spawned{0};
+			uint64_t died{0};
+			uint64_t survived{0};
+			uint64_t wins{0};		   // runs where the survivors were of this type only
+			QuantileSketch damageDealt; // total per unit and run
+			QuantileSketch deathRound;
+		};
+
+	private:
+		struct RunUnit
+		{
+			uint32_t type{0};
+			uint64_t damage{0};
+			bool alive{true};
+		};
+
+		uint64_t _runs{0};
+		uint64_t _draws{0}; // runs ending with no survivors
+		uint64_t _undecided{0}; // runs ending with survivors of different types
+		QuantileSketch _rounds;
+		QuantileSketch _survivors;
+		QuantileSketch _killRounds;
+		std::vector<TypeStats> _types;
+		std::unordered_map<uint32_t, RunUnit> _run; // units of the current run by id
+
+		uint32_t typeIndexOf(const std::string& name);
+
+	public:
+		void attach(EventLog& eventLog);
+		// closes the current run: per-unit damage and survivors go into the sketches
+		void finishRun(uint32_t rounds);
+		// adds the other runs, unit types are matched by name
+		void merge(const BattleStats& other);
+
+		[[nodiscard]] uint64_t getRuns() const noexcept { return _runs; }
+		[[nodiscard]] const std::vector<TypeStats>& getTypes() const noexcept { return _types; }
+		void writeJson(std::ostream& stream) const;
+	};
+}
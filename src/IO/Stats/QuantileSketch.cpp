@@ -0,0 +1,139 @@
+#include "QuantileSketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sw::stats
+{
+	namespace
+	{
+		// below this a value counts as zero, keys stay within int32
+		constexpr double MIN_INDEXED_VALUE = 1e-9;
+	}
+
+	QuantileSketch::QuantileSketch(double relativeAccuracy, size_t maxBuckets) :
+			_accuracy(relativeAccuracy),
+			_gamma((1 + relativeAccuracy) / (1 - relativeAccuracy)),
+			_logGamma(std::log(_gamma)),
+			_maxBuckets(maxBuckets)
+	{
+		if (relativeAccuracy <= 0 || relativeAccuracy >= 1 || maxBuckets < 2)
+		{
+			throw std::runtime_error("QuantileSketch: accuracy must be in (0, 1) and at least 2 buckets allowed");
+		}
+	}
+
+	int32_t QuantileSketch::keyOf(double value) const noexcept
+	{
+		return static_cast<int32_t>(std::ceil(std::log(value) / _logGamma));
+	}
+
+	double QuantileSketch::valueOf(int32_t key) const noexcept
+	{
+		// the point of the bucket (gamma^(k-1), gamma^k] with the smallest relative error
+		return 2 * std::pow(_gamma, key) / (_gamma + 1);
+	}
+
+	void QuantileSketch::addToKey(int32_t key, uint64_t count)
+	{
+		if (_buckets.empty())
+		{
+			_offset = key;
+			_buckets.push_back(0);
+		}
+		else if (key < _offset)
+		{
+			_buckets.insert(_buckets.begin(), static_cast<size_t>(_offset - key), 0);
+			_offset = key;
+		}
+		else if (key >= _offset + static_cast<int32_t>(_buckets.size()))
+		{
+			_buckets.resize(static_cast<size_t>(key - _offset) + 1, 0);
+		}
+		_buckets[static_cast<size_t>(key - _offset)] += count;
+		if (_buckets.size() > _maxBuckets)
+		{
+			collapse();
+		}
+	}
+
+	void QuantileSketch::collapse()
+	{
+		const size_t extra = _buckets.size() - _maxBuckets;
+		uint64_t folded = 0;
+		for (size_t i = 0; i <= extra; ++i)
+		{
+			folded += _buckets[i];
+		}
+		_buckets.erase(_buckets.begin(), _buckets.begin() + static_cast<std::ptrdiff_t>(extra));
+		_buckets.front() = folded;
+		_offset += static_cast<int32_t>(extra);
+	}
+
+	void QuantileSketch::add(double value, uint64_t count)
+	{
+		if (!count)
+		{
+			return;
+		}
+		_count += count;
+		_sum += value * static_cast<double>(count);
+		_min = std::min(_min, value);
+		_max = std::max(_max, value);
+		if (value < MIN_INDEXED_VALUE)
+		{
+			_zeros += count;
+			return;
+		}
+		addToKey(keyOf(value), count);
+	}
+
+	void QuantileSketch::merge(const QuantileSketch& other)
+	{
+		if (other._accuracy != _accuracy)
+		{
+			throw std::runtime_error("QuantileSketch: cannot merge sketches of different accuracy");
+		}
+		if (!other._count)
+		{
+			return;
+		}
+		_count += other._count;
+		_sum += other._sum;
+		_min = std::min(_min, other._min);
+		_max = std::max(_max, other._max);
+		_zeros += other._zeros;
+		for (size_t i = 0; i < other._buckets.size(); ++i)
+		{
+			if (other._buckets[i])
+			{
+				addToKey(other._offset + static_cast<int32_t>(i), other._buckets[i]);
+			}
+		}
+	}
+
+	double QuantileSketch::quantile(double q) const noexcept
+	{
+		if (!_count)
+		{
+			return 0;
+		}
+		const auto rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(_count - 1));
+		if (rank < _zeros)
+		{
+			return std::max(_min, 0.0);
+		}
+		uint64_t seen = _zeros;
+		for (size_t i = 0; i < _buckets.size(); ++i)
+		{
+			seen += _buckets[i];
+			if (seen > rank)
+			{
+				// exact extremes are known, keep the estimate inside them
+				return std::clamp(valueOf(_offset + static_cast<int32_t>(i)), _min, _max);
+			}
+		}
+		return _max;
+	}
+}
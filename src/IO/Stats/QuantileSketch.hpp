@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sw::stats
+{
+	// DDSketch: quantiles of non-negative values with a relative error bound. Value x goes to the bucket
+	// ceil(log_gamma(x)), gamma = (1 + a) / (1 - a), so every quantile is within a * value of the exact one.
+	// Two sketches with the same accuracy merge by adding bucket counts, the result is the sketch of the union.
+	// Buckets are dense around the seen range; past maxBuckets the lowest ones are collapsed (the low tail loses
+	// precision first).
+	class QuantileSketch
+	{
+		double _accuracy;
+		double _gamma;
+		double _logGamma;
+		size_t _maxBuckets;
+		std::vector<uint64_t> _buckets; // _buckets[i] counts key _offset + i
+		int32_t _offset{0};
+		uint64_t _zeros{0}; // values too small to have a key, zero included
+		uint64_t _count{0};
+		double _sum{0};
+		double _min{std::numeric_limits<double>::infinity()};
+		double _max{-std::numeric_limits<double>::infinity()};
+
+		[[nodiscard]] int32_t keyOf(double value) const noexcept;
+		[[nodiscard]] double valueOf(int32_t key) const noexcept;
+		void addToKey(int32_t key, uint64_t count);
+		void collapse();
+
+	public:
+		explicit QuantileSketch(double relativeAccuracy = 0.01, size_t maxBuckets = 2048);
+
+		void add(double value, uint64_t count = 1);
+		// accuracies must match
+		void merge(const QuantileSketch& other);
+
+		// q in [0, 1], 0 for an empty sketch
+		[[nodiscard]] double quantile(double q) const noexcept;
+		[[nodiscard]] uint64_t getCount() const noexcept { return _count; }
+		[[nodiscard]] double getSum() const noexcept { return _sum; }
+		[[nodiscard]] double getMin() const noexcept { return _count ? _min : 0; }
+		[[nodiscard]] double getMax() const noexcept { return _count ? _max : 0; }
+		[[nodiscard]] double getMean() const noexcept { return _count ? _sum / static_cast<double>(_count) : 0; }
+		[[nodiscard]] double getAccuracy() const noexcept { return _accuracy; }
+	};
+}
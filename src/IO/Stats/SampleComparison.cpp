@@ -0,0 +1,117 @@
+#include "SampleComparison.hpp"
+
+#include <cmath>
+
+namespace sw::stats
+{
+	namespace
+	{
+		// continued fraction of the incomplete beta function, modified Lentz's method
+		double betaContinuedFraction(double a, double b, double x)
+		{
+			constexpr double TINY = 1e-300;
+			constexpr double EPSILON = 1e-12;
+			const auto guard = [](double v) { return std::fabs(v) < TINY ? TINY : v; };
+			double c = 1;
+			double d = 1 / guard(1 - (a + b) * x / (a + 1));
+			double h = d;
+			for (int m = 1; m <= 300; ++m)
+			{
+				const double even = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+				d = 1 / guard(1 + even * d);
+				c = guard(1 + even / c);
+				h *= d * c;
+				const double odd = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+				d = 1 / guard(1 + odd * d);
+				c = guard(1 + odd / c);
+				const double step = d * c;
+				h *= step;
+				if (std::fabs(step - 1) < EPSILON)
+				{
+					break;
+				}
+			}
+			return h;
+		}
+
+		// regularized incomplete beta I_x(a, b)
+		double incompleteBeta(double a, double b, double x)
+		{
+			if (x <= 0)
+			{
+				return 0;
+			}
+			if (x >= 1)
+			{
+				return 1;
+			}
+			const double front =
+				std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log1p(-x));
+			// the fraction converges fast on this side of the mean, the other side goes through the symmetry
+			if (x < (a + 1) / (a + b + 2))
+			{
+				return front * betaContinuedFraction(a, b, x) / a;
+			}
+			return 1 - front * betaContinuedFraction(b, a, 1 - x) / b;
+		}
+	}
+
+	SampleSummary summarize(const std::vector<double>& samples)
+	{
+		SampleSummary summary;
+		summary.count = samples.size();
+		if (samples.empty())
+		{
+			return summary;
+		}
+		for (const double value : samples)
+		{
+			summary.mean += value;
+		}
+		summary.mean /= static_cast<double>(samples.size());
+		if (samples.size() > 1)
+		{
+			double squares = 0;
+			for (const double value : samples)
+			{
+				squares += (value - summary.mean) * (value - summary.mean);
+			}
+			summary.stddev = std::sqrt(squares / static_cast<double>(samples.size() - 1));
+		}
+		return summary;
+	}
+
+	double studentTwoSidedP(double t, double degreesOfFreedom)
+	{
+		if (degreesOfFreedom <= 0)
+		{
+			return 1;
+		}
+		return incompleteBeta(degreesOfFreedom / 2, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+	}
+
+	WelchTest welchTest(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		const SampleSummary sa = summarize(a);
+		const SampleSummary sb = summarize(b);
+		WelchTest result;
+		if (sa.count == 0 || sb.count == 0)
+		{
+			return result;
+		}
+		const double va = sa.stddev * sa.stddev / static_cast<double>(sa.count);
+		const double vb = sb.stddev * sb.stddev / static_cast<double>(sb.count);
+		if (va + vb == 0)
+		{
+			result.pValue = sa.mean == sb.mean ? 1 : 0;
+			return result;
+		}
+		result.t = (sb.mean - sa.mean) / std::sqrt(va + vb);
+		// a single sample has no variance estimate and adds no degrees of freedom
+		const double da = sa.count > 1 ? va * va / static_cast<double>(sa.count - 1) : 0;
+		const double db = sb.count > 1 ? vb * vb / static_cast<double>(sb.count - 1) : 0;
+		result.degreesOfFreedom = (va + vb) * (va + vb) / (da + db);
+		result.pValue = studentTwoSidedP(result.t, result.degreesOfFreedom);
+		return result;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace sw::stats
+{
+	// mean and sample standard deviation (n - 1) of repeated measurements, the deviation is 0 below two samples
+	struct SampleSummary
+	{
+		size_t count{0};
+		double mean{0};
+		double stddev{0};
+	};
+	SampleSummary summarize(const std::vector<double>& samples);
+
+	// Welch's t-test of two independent samples with unequal variances: t of (mean b - mean a), the
+	// Welch-Satterthwaite degrees of freedom and the two-sided p-value. Measurements without spread on both sides
+	// (counters of a deterministic run) have no noise to test against: p is 0 when the means differ, 1 otherwise
+	struct WelchTest
+	{
+		double t{0};
+		double degreesOfFreedom{0};
+		double pValue{1};
+	};
+	WelchTest welchTest(const std::vector<double>& a, const std::vector<double>& b);
+
+	// P(|T| >= |t|) for Student's t distribution with df degrees of freedom
+	double studentTwoSidedP(double t, double degreesOfFreedom);
+}
@@ -30,4 +30,25 @@ namespace sw::io
 			command->second(commandStream);
 		}
 	}
+
+	void CommandParser::parseBinary(std::istream& stream)
+	{
+		int nameLength;
+		while ((nameLength = stream.get()) != std::char_traits<char>::eof())
+		{
+			std::string commandName(static_cast<size_t>(nameLength), '\0');
+			if (!stream.read(commandName.data(), nameLength))
+			{
+				throw std::runtime_error("Truncated binary command name");
+			}
+
+			auto command = _binaryCommands.find(commandName);
+			if (command == _binaryCommands.end())
+			{
+				throw std::runtime_error("Unknown command: " + commandName);
+			}
+
+			command->second(stream);
+		}
+	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "details/BinaryCommandVisitors.hpp"
 #include "details/CommandParserVisitor.hpp"
 
 #include <functional>
@@ -12,17 +13,25 @@ namespace sw::io
 	{
 	private:
 		std::unordered_map<std::string, std::function<void(std::istream&)>> _commands;
+		std::unordered_map<std::string, std::function<void(std::istream&)>> _binaryCommands;
 
 	public:
 		template <class TCommandData>
 		CommandParser& add(std::function<void(TCommandData)> handler)
 		{
-			std::string commandName = TCommandData::Name;
+			return add(TCommandData{}, std::move(handler));
+		}
+
+		// commands named at run time: every parsed command starts as a copy of the prototype, named by prototype.Name
+		template <class TCommandData>
+		CommandParser& add(TCommandData prototype, std::function<void(TCommandData)> handler)
+		{
+			std::string commandName = prototype.Name;
 			auto [it, inserted] = _commands.emplace(
 				commandName,
-				[handler = std::move(handler)](std::istream& stream)
+				[handler, prototype](std::istream& stream)
 				{
-					TCommandData data;
+					TCommandData data = prototype;
 					CommandParserVisitor visitor(stream);
 					data.visit(visitor);
 					handler(std::move(data));
@@ -31,10 +40,21 @@ namespace sw::io
 			{
 				throw std::runtime_error("Command already exists: " + commandName);
 			}
+			_binaryCommands.emplace(
+				commandName,
+				[handler = std::move(handler), prototype = std::move(prototype)](std::istream& stream)
+				{
+					TCommandData data = prototype;
+					BinaryCommandParserVisitor visitor(stream);
+					data.visit(visitor);
+					handler(std::move(data));
+				});
 
 			return *this;
 		}
 
 		void parse(std::istream& stream);
+		// same commands in the binary record format (see BinaryCommandVisitors.hpp)
+		void parseBinary(std::istream& stream);
 	};
 }
@@ -1,22 +1,143 @@
 #pragma once
 
-#include "details/PrintFieldVisitor.hpp"
+#include "EventTypes.hpp"
+#include "details/CountingStreamBuf.hpp"
+#include "details/EventLineBuffer.hpp"
+
+#include <Core/Engine/Profiler.hpp>
+#include <bitset>
+#include <functional>
 #include <iostream>
-#include <typeindex>
-#include <unordered_map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace sw
 {
+	template <class TEvent>
+	using EventSink = std::function<void(uint64_t tick, const TEvent& event)>;
+
+	// Event bus: every event type from EventTypes has its own list of sinks, resolved at compile time, plus the
+	// text output (all types by default). An event nobody wants is not even built when emitted via emit().
 	class EventLog
 	{
+	private:
+		template <class TList>
+		struct SinkTable;
+		template <class... TEvents>
+		struct SinkTable<EventTypeList<TEvents...>>
+		{
+			using type = std::tuple<std::vector<EventSink<TEvents>>...>;
+		};
+		template <class TEvent>
+		static constexpr size_t indexOf = EventIndex<std::decay_t<TEvent>, EventTypes>::value;
+
+		CountingStreamBuf _buffer;
+		EventLineBuffer _line; // text output, flushed when full and after every round
+		uint64_t _eventsLogged{0};
+		SinkTable<EventTypes>::type _sinks;
+		std::bitset<EventTypes::Count> _text;	// types formatted to the text output
+		std::bitset<EventTypes::Count> _wanted; // text output or at least one sink
+
+		template <class TEvent>
+		void dispatch(uint64_t tick, TEvent& event)
+		{
+			constexpr size_t index = indexOf<TEvent>;
+			if (_text.test(index))
+			{
+				SW_PROFILE_SCOPE("EventLog::log");
+				writeEventLine(_line, tick, event);
+			}
+			for (const auto& sink : std::get<index>(_sinks))
+			{
+				sink(tick, event);
+			}
+			++_eventsLogged;
+		}
+
 	public:
+		explicit EventLog(std::ostream& target = std::cout) :
+				_buffer(target.rdbuf()),
+				_line(&_buffer)
+		{
+			_text.set();
+			_wanted.set();
+		}
+
+		template <class TEvent>
+		void subscribe(EventSink<TEvent> sink)
+		{
+			constexpr size_t index = indexOf<TEvent>;
+			std::get<index>(_sinks).push_back(std::move(sink));
+			_wanted.set(index);
+		}
+
+		// limits the text output to the named event types (e.g. "UNIT_DIED"), an empty list turns it off
+		void setTextEvents(const std::vector<std::string>& names)
+		{
+			_text.reset();
+			for (const auto& name : names)
+			{
+				bool found = false;
+				[&]<class... TEvents>(EventTypeList<TEvents...>)
+				{
+					((name == TEvents::Name ? (_text.set(indexOf<TEvents>), found = true) : false), ...);
+				}(EventTypes{});
+				if (!found)
+				{
+					throw std::runtime_error("Unknown event type: " + name);
+				}
+			}
+			[&]<class... TEvents>(EventTypeList<TEvents...>)
+			{
+				((_wanted[indexOf<TEvents>] = _text.test(indexOf<TEvents>) || !std::get<indexOf<TEvents>>(_sinks).empty()), ...);
+			}(EventTypes{});
+		}
+
 		template <class TEvent>
-		void log(uint64_t tick, TEvent&& event)
+		[[nodiscard]] bool wants() const noexcept
+		{
+			return _wanted.test(indexOf<TEvent>);
+		}
+
+		// event that is already built, for rare events; hot paths use emit()
+		template <class TEvent>
+		void log(uint64_t tick, TEvent event)
+		{
+			if (wants<TEvent>())
+			{
+				dispatch(tick, event);
+			}
+		}
+
+		// make() builds the event only if some sink or the text output wants it: emit<UnitMoved>(tick, [&] { ... })
+		template <class TEvent, class TFactory>
+		void emit(uint64_t tick, TFactory&& make)
+		{
+			if (wants<TEvent>())
+			{
+				TEvent event = make();
+				dispatch(tick, event);
+			}
+		}
+
+		// hands the buffered text to the target stream
+		void flush()
+		{
+			_line.flush();
+			_buffer.pubsync();
+		}
+
+		[[nodiscard]] uint64_t getEventsLogged() const noexcept
+		{
+			return _eventsLogged;
+		}
+
+		[[nodiscard]] uint64_t getBytesLogged() const noexcept
 		{
-			std::cout << "[" << tick << "] " << TEvent::Name << " ";
-			PrintFieldVisitor visitor(std::cout);
-			event.visit(visitor);
-			std::cout << std::endl;
+			return _buffer.getBytes() + _line.pending();
 		}
 	};
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "IO/Events/MapCreated.hpp"
+#include "IO/Events/MarchEnded.hpp"
+#include "IO/Events/MarchStarted.hpp"
+#include "IO/Events/UnitAttacked.hpp"
+#include "IO/Events/UnitDied.hpp"
+#include "IO/Events/UnitExploded.hpp"
+#include "IO/Events/UnitHealed.hpp"
+#include "IO/Events/UnitMoved.hpp"
+#include "IO/Events/UnitSpawned.hpp"
+#include "IO/Events/WorldHash.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace sw
+{
+	template <class... TEvents>
+	struct EventTypeList
+	{
+		static constexpr size_t Count = sizeof...(TEvents);
+	};
+
+	// every event the engine can emit, a new event type must be added here
+	using EventTypes = EventTypeList<
+		io::MapCreated,
+		io::UnitSpawned,
+		io::MarchStarted,
+		io::MarchEnded,
+		io::UnitMoved,
+		io::UnitAttacked,
+		io::UnitHealed,
+		io::UnitExploded,
+		io::UnitDied,
+		io::WorldHash>;
+
+	// position of TEvent in the list, compile error if it is not there
+	template <class TEvent, class TList>
+	struct EventIndex;
+
+	template <class TEvent, class... TEvents>
+	struct EventIndex<TEvent, EventTypeList<TEvents...>>
+	{
+		static constexpr size_t find()
+		{
+			constexpr bool matches[] = {std::is_same_v<TEvent, TEvents>...};
+			for (size_t i = 0; i < sizeof...(TEvents); ++i)
+			{
+				if (matches[i])
+				{
+					return i;
+				}
+			}
+			return sizeof...(TEvents);
+		}
+		static constexpr size_t value = find();
+		static_assert(value < sizeof...(TEvents), "event type is not listed in EventTypes");
+	};
+}
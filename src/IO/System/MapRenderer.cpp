@@ -0,0 +1,160 @@
+//
+// Created by Carpov Pavel on 22.10.2025.
+//
+
+#include "MapRenderer.hpp"
+
+#include "Core/Engine/MapUnitsController.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <ostream>
+
+namespace sw
+{
+	MapRenderer::MapRenderer(const Viewport& viewport_, std::chrono::milliseconds minFrameInterval_) :
+		viewport(viewport_), minFrameInterval(minFrameInterval_)
+	{
+		viewport.zoom = std::max<uint32_t>(viewport.zoom, 1);
+		frame.resize(static_cast<size_t>(viewport.width) * viewport.height);
+		output.reserve(frame.size() * (CELL_WIDTH + 12));
+	}
+
+	Viewport MapRenderer::fitToMap(uint32_t mapWidth, uint32_t mapHeight, uint32_t maxWidth, uint32_t maxHeight)
+	{
+		Viewport result;
+		const uint64_t zoomX = (static_cast<uint64_t>(mapWidth) + maxWidth - 1) / maxWidth;
+		const uint64_t zoomY = (static_cast<uint64_t>(mapHeight) + maxHeight - 1) / maxHeight;
+		result.zoom = static_cast<uint32_t>(std::max<uint64_t>({zoomX, zoomY, 1}));
+		result.width = static_cast<uint32_t>((mapWidth + static_cast<uint64_t>(result.zoom) - 1) / result.zoom);
+		result.height = static_cast<uint32_t>((mapHeight + static_cast<uint64_t>(result.zoom) - 1) / result.zoom);
+		return result;
+	}
+
+	void MapRenderer::clear()
+	{
+		std::fill(frame.begin(), frame.end(), Cell{});
+	}
+
+	void MapRenderer::plot(int32_t x, int32_t y, std::string_view name, bool solid)
+	{
+		const int64_t dx = static_cast<int64_t>(x) - viewport.x;
+		const int64_t dy = static_cast<int64_t>(y) - viewport.y;
+		if (dx < 0 || dy < 0)
+		{
+			return;
+		}
+		const uint64_t column = static_cast<uint64_t>(dx) / viewport.zoom;
+		const uint64_t row = static_cast<uint64_t>(dy) / viewport.zoom;
+		if (column >= viewport.width || row >= viewport.height)
+		{
+			return;
+		}
+		Cell& cell = frame[row * viewport.width + column];
+		cell.count = static_cast<uint16_t>(std::min<uint32_t>(cell.count + 1u, UINT16_MAX));
+		// solid units are drawn over mines and other non-solid objects
+		if (cell.count == 1 || (solid && !cell.solid))
+		{
+			cell.glyph[0] = name.size() > 0 ? name[0] : '?';
+			cell.glyph[1] = name.size() > 1 ? name[1] : ' ';
+			cell.solid = solid;
+		}
+	}
+
+	void MapRenderer::draw(const sw::core::MapUnitsController& map, std::ostream& stream, bool force)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if (!force && hasPrevious && now - lastPresent < minFrameInterval)
+		{
+			return; // keep up with the simulation instead of the terminal
+		}
+		clear();
+		const int64_t zoom = viewport.zoom;
+		const int64_t maxX = std::min<int64_t>(INT32_MAX, viewport.x + zoom * viewport.width - 1);
+		const int64_t maxY = std::min<int64_t>(INT32_MAX, viewport.y + zoom * viewport.height - 1);
+		map.forEachUnitInBox(sw::core::Coordinate(std::max(viewport.x, 0), std::max(viewport.y, 0)),
+			sw::core::Coordinate(static_cast<int32_t>(maxX), static_cast<int32_t>(maxY)),
+			[this](const sw::core::Unit& unit)
+			{ plot(unit.getPosition().getX(), unit.getPosition().getY(), unit.getName(), unit.isSolid()); });
+		present(stream);
+		lastPresent = now;
+	}
+
+	void MapRenderer::appendCursor(uint32_t row, uint32_t column)
+	{
+		char buffer[24];
+		output += "\x1b[";
+		output.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), row + 1).ptr);
+		output += ';';
+		output.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), column * CELL_WIDTH + 1).ptr);
+		output += 'H';
+	}
+
+	void MapRenderer::appendCell(const Cell& cell)
+	{
+		output += '[';
+		if (cell.count > 1 && viewport.zoom > 1)
+		{
+			if (cell.count > 99)
+			{
+				output += "**";
+			}
+			else
+			{
+				char buffer[4];
+				auto end = std::to_chars(buffer, buffer + sizeof(buffer), cell.count).ptr;
+				if (end - buffer == 1)
+				{
+					output += ' ';
+				}
+				output.append(buffer, end);
+			}
+		}
+		else
+		{
+			output.append(cell.glyph, 2);
+		}
+		output += ']';
+	}
+
+	void MapRenderer::present(std::ostream& stream)
+	{
+		output.clear();
+		if (!hasPrevious)
+		{
+			// first frame: clear the screen and draw everything
+			output += "\x1b[2J\x1b[H";
+			for (uint32_t row = 0; row < viewport.height; ++row)
+			{
+				for (uint32_t column = 0; column < viewport.width; ++column)
+				{
+					appendCell(frame[row * viewport.width + column]);
+				}
+				output += '\n';
+			}
+		}
+		else
+		{
+			for (uint32_t row = 0; row < viewport.height; ++row)
+			{
+				for (uint32_t column = 0; column < viewport.width; ++column)
+				{
+					const size_t index = row * viewport.width + column;
+					if (frame[index] == previous[index])
+					{
+						continue;
+					}
+					appendCursor(row, column);
+					appendCell(frame[index]);
+				}
+			}
+			// park the cursor below the map
+			appendCursor(viewport.height, 0);
+		}
+		stream.write(output.data(), static_cast<std::streamsize>(output.size()));
+		stream.flush();
+		previous.swap(frame);
+		frame.resize(previous.size());
+		hasPrevious = true;
+	}
+}
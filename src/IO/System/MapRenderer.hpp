@@ -0,0 +1,78 @@
+//
+// Created by Carpov Pavel on 22.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_MAPRENDERER_HPP
+#define SW_BATTLE_TEST_MAPRENDERER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::core
+{
+	class MapUnitsController;
+}
+
+namespace sw
+{
+	// Visible part of the world: top-left world cell, size in screen cells and world cells per screen cell edge
+	struct Viewport
+	{
+		int32_t x{0};
+		int32_t y{0};
+		uint32_t width{80};
+		uint32_t height{40};
+		uint32_t zoom{1};
+	};
+
+	// Terminal map view. A frame is built into a framebuffer in one pass over the units inside the viewport,
+	// then only the cells changed since the previous frame are redrawn with ANSI cursor moves.
+	class MapRenderer
+	{
+	public:
+		// every screen cell is printed as 4 characters: "[Sw]", "[  ]", or "[12]" for several units in a zoomed cell
+		static constexpr uint32_t CELL_WIDTH = 4;
+
+	private:
+		struct Cell
+		{
+			char glyph[2]{' ', ' '};
+			uint16_t count{0};
+			bool solid{false};
+
+			bool operator==(const Cell&) const = default;
+		};
+
+		Viewport viewport;
+		std::vector<Cell> frame;
+		std::vector<Cell> previous;
+		bool hasPrevious{false};
+		std::string output; // reused between frames
+		std::chrono::steady_clock::duration minFrameInterval;
+		std::chrono::steady_clock::time_point lastPresent{};
+
+		void appendCell(const Cell& cell);
+		void appendCursor(uint32_t row, uint32_t column);
+
+	public:
+		explicit MapRenderer(const Viewport& viewport_, std::chrono::milliseconds minFrameInterval_ = std::chrono::milliseconds(33));
+
+		[[nodiscard]] const Viewport& getViewport() const noexcept { return viewport; }
+
+		// viewport that shows the whole map inside a maxWidth x maxHeight screen
+		static Viewport fitToMap(uint32_t mapWidth, uint32_t mapHeight, uint32_t maxWidth = 80, uint32_t maxHeight = 40);
+
+		// frame building: clear, plot units, present
+		void clear();
+		void plot(int32_t x, int32_t y, std::string_view name, bool solid);
+		// renders the map, frames arriving faster than the frame interval are dropped unless forced
+		void draw(const sw::core::MapUnitsController& map, std::ostream& stream, bool force = false);
+		void present(std::ostream& stream);
+	};
+}
+
+#endif	//SW_BATTLE_TEST_MAPRENDERER_HPP
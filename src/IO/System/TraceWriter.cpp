@@ -0,0 +1,43 @@
+//
+// Created by Carpov Pavel on 20.10.2025.
+//
+
+#include "TraceWriter.hpp"
+
+#include <ostream>
+
+namespace sw
+{
+	void TraceWriter::writeJson(std::ostream& stream) const
+	{
+		// timestamps are in microseconds; keep ns precision with 3 decimals
+		const auto printMicros = [&stream](uint64_t ns) { stream << ns / 1000 << '.' << (ns % 1000) / 100 << (ns % 100) / 10 << ns % 10; };
+
+		stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		stream << R"({"name":"process_name","ph":"M","pid":1,"tid":1,"args":{"name":"sw_battle_test"}})";
+		stream << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":1,"args":{"name":"simulation"}})";
+		for (const auto& record : records)
+		{
+			stream << ",\n{\"name\":\"" << record.name << "\",\"ph\":\"" << record.phase << "\",\"pid\":1,\"tid\":1,\"ts\":";
+			printMicros(record.startNs);
+			if (record.phase == 'X')
+			{
+				stream << ",\"dur\":";
+				printMicros(record.durationNs);
+			}
+			stream << ",\"args\":{";
+			bool first = true;
+			for (const auto& arg : record.args)
+			{
+				if (!arg.key)
+				{
+					continue;
+				}
+				stream << (first ? "" : ",") << '"' << arg.key << "\":" << arg.value;
+				first = false;
+			}
+			stream << "}}";
+		}
+		stream << "\n]}\n";
+	}
+}
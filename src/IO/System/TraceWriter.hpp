@@ -0,0 +1,94 @@
+//
+// Created by Carpov Pavel on 20.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_TRACEWRITER_HPP
+#define SW_BATTLE_TEST_TRACEWRITER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace sw
+{
+	// integer argument attached to a trace record, key must be a static string
+	struct TraceArg
+	{
+		const char* key{nullptr};
+		int64_t value{0};
+	};
+
+	// Collects Chrome trace-event records in memory and writes them as JSON (chrome://tracing, ui.perfetto.dev)
+	class TraceWriter
+	{
+	private:
+		struct Record
+		{
+			const char* name{nullptr}; // static string, not owned
+			char phase{'X'};		   // 'X' complete span, 'C' counter
+			uint64_t startNs{0};
+			uint64_t durationNs{0};
+			TraceArg args[2]{};
+		};
+
+		std::vector<Record> records;
+		std::chrono::steady_clock::time_point origin{std::chrono::steady_clock::now()};
+
+	public:
+		TraceWriter() { records.reserve(1 << 16); }
+
+		[[nodiscard]] uint64_t now() const noexcept
+		{
+			return static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+		}
+
+		void addSpan(const char* name, uint64_t startNs, uint64_t endNs, TraceArg first = {}, TraceArg second = {})
+		{
+			records.push_back(Record{name, 'X', startNs, endNs - startNs, {first, second}});
+		}
+
+		void addCounter(const char* name, int64_t value)
+		{
+			records.push_back(Record{name, 'C', now(), 0, {TraceArg{"value", value}, TraceArg{}}});
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return records.size(); }
+
+		void writeJson(std::ostream& stream) const;
+	};
+
+	// RAII span, does nothing when no writer is attached
+	class TraceSpan
+	{
+		TraceWriter* writer;
+		const char* name;
+		uint64_t start{0};
+		TraceArg args[2]{};
+
+	public:
+		TraceSpan(TraceWriter* writer_, const char* name_, TraceArg first = {}) :
+			writer(writer_), name(name_), args{first, {}}
+		{
+			if (writer)
+			{
+				start = writer->now();
+			}
+		}
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+		void setArg(const char* key, int64_t value) noexcept { args[1] = TraceArg{key, value}; }
+
+		~TraceSpan()
+		{
+			if (writer)
+			{
+				writer->addSpan(name, start, writer->now(), args[0], args[1]);
+			}
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_TRACEWRITER_HPP
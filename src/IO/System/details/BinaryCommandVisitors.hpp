@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace sw
+{
+	// Binary scenario record: [u8 name length][name][fields in visit() order, little-endian, sizeof(field) bytes each]
+	// Optional fields are always present in records, the layout of a command is fixed
+
+	class BinaryCommandParserVisitor
+	{
+	private:
+		std::istream& _stream;
+
+	public:
+		explicit BinaryCommandParserVisitor(std::istream& stream) :
+				_stream(stream)
+		{}
+
+		template <class TField>
+		void visit(const char* name, TField& field)
+		{
+			static_assert(std::is_integral_v<TField>, "binary scenarios support integral fields only");
+			unsigned char bytes[sizeof(TField)];
+			if (!_stream.read(reinterpret_cast<char*>(bytes), sizeof(TField)))
+			{
+				throw std::runtime_error(std::string("Truncated binary command field: ") + name);
+			}
+			std::make_unsigned_t<TField> value{};
+			for (size_t i = 0; i < sizeof(TField); ++i)
+			{
+				value |= static_cast<std::make_unsigned_t<TField>>(bytes[i]) << (8 * i);
+			}
+			field = static_cast<TField>(value);
+		}
+
+		template <class TField>
+		void visitOptional(const char* name, TField& field)
+		{
+			visit(name, field);
+		}
+	};
+
+	class BinaryCommandWriterVisitor
+	{
+	private:
+		std::ostream& _stream;
+
+	public:
+		explicit BinaryCommandWriterVisitor(std::ostream& stream) :
+				_stream(stream)
+		{}
+
+		template <typename TCommand>
+		static void write(std::ostream& stream, TCommand& command)
+		{
+			const std::string name = command.Name;
+			stream.put(static_cast<char>(name.size()));
+			stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+			BinaryCommandWriterVisitor visitor(stream);
+			command.visit(visitor);
+		}
+
+		template <class TField>
+		void visit(const char*, const TField& field)
+		{
+			static_assert(std::is_integral_v<TField>, "binary scenarios support integral fields only");
+			const auto value = static_cast<std::make_unsigned_t<TField>>(field);
+			for (size_t i = 0; i < sizeof(TField); ++i)
+			{
+				_stream.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+			}
+		}
+
+		template <class TField>
+		void visitOptional(const char* name, const TField& field)
+		{
+			visit(name, field);
+		}
+	};
+}
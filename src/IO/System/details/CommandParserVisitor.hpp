@@ -19,5 +19,15 @@ namespace sw
 		{
 			_stream >> field;
 		}
+
+		// trailing field that may be left out, the field keeps its default then
+		template <class TField>
+		void visitOptional(const char*, TField& field)
+		{
+			if (!(_stream >> std::ws).eof())
+			{
+				_stream >> field;
+			}
+		}
 	};
 }
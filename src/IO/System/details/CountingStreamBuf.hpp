@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <streambuf>
+
+namespace sw
+{
+	// Forwards everything to another streambuf and counts the bytes written through it
+	class CountingStreamBuf : public std::streambuf
+	{
+	private:
+		std::streambuf* _target;
+		uint64_t _bytes{0};
+
+	public:
+		explicit CountingStreamBuf(std::streambuf* target) :
+				_target(target)
+		{}
+
+		[[nodiscard]] uint64_t getBytes() const noexcept
+		{
+			return _bytes;
+		}
+
+	protected:
+		int_type overflow(int_type ch) override
+		{
+			if (traits_type::eq_int_type(ch, traits_type::eof()))
+			{
+				return traits_type::not_eof(ch);
+			}
+			++_bytes;
+			return _target->sputc(traits_type::to_char_type(ch));
+		}
+
+		std::streamsize xsputn(const char_type* s, std::streamsize count) override
+		{
+			_bytes += static_cast<uint64_t>(count);
+			return _target->sputn(s, count);
+		}
+
+		int sync() override
+		{
+			return _target->pubsync();
+		}
+	};
+}
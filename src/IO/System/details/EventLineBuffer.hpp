@@ -0,0 +1,135 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sw
+{
+	// Preallocated output buffer for event lines: numbers are written with std::to_chars, text with memcpy, and
+	// only full buffers (or explicit flushes) reach the sink
+	class EventLineBuffer
+	{
+	private:
+		static constexpr size_t MAX_NUMBER_CHARS = 24;
+
+		std::streambuf* _sink;
+		std::unique_ptr<char[]> _data;
+		char* _cursor;
+		char* _end;
+
+		void ensure(size_t size)
+		{
+			if (static_cast<size_t>(_end - _cursor) < size)
+			{
+				flush();
+			}
+		}
+
+	public:
+		explicit EventLineBuffer(std::streambuf* sink, size_t capacity = 64 * 1024) :
+				_sink(sink),
+				_data(new char[capacity]),
+				_cursor(_data.get()),
+				_end(_data.get() + capacity)
+		{}
+		~EventLineBuffer()
+		{
+			flush();
+		}
+		EventLineBuffer(const EventLineBuffer&) = delete;
+		EventLineBuffer& operator=(const EventLineBuffer&) = delete;
+
+		void put(char ch)
+		{
+			ensure(1);
+			*_cursor++ = ch;
+		}
+
+		void append(std::string_view text)
+		{
+			ensure(text.size());
+			if (static_cast<size_t>(_end - _cursor) < text.size())
+			{
+				// longer than the whole buffer, goes straight to the sink
+				_sink->sputn(text.data(), static_cast<std::streamsize>(text.size()));
+				return;
+			}
+			std::memcpy(_cursor, text.data(), text.size());
+			_cursor += text.size();
+		}
+
+		template <typename T>
+		void appendValue(const T& value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				put(value ? '1' : '0');
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				ensure(MAX_NUMBER_CHARS);
+				_cursor = std::to_chars(_cursor, _end, value).ptr;
+			}
+			else
+			{
+				append(std::string_view(value));
+			}
+		}
+
+		[[nodiscard]] size_t pending() const noexcept
+		{
+			return static_cast<size_t>(_cursor - _data.get());
+		}
+
+		void flush()
+		{
+			if (_cursor != _data.get())
+			{
+				_sink->sputn(_data.get(), static_cast<std::streamsize>(pending()));
+				_cursor = _data.get();
+			}
+		}
+	};
+
+	// writes fields in the same "name=value " layout as PrintFieldVisitor
+	class CharsFieldVisitor
+	{
+	private:
+		EventLineBuffer& _out;
+
+	public:
+		explicit CharsFieldVisitor(EventLineBuffer& out) :
+				_out(out)
+		{}
+
+		template <typename T>
+		void visit(const char* name, const T& value)
+		{
+			_out.append(name);
+			_out.put('=');
+			_out.appendValue(value);
+			_out.put(' ');
+		}
+	};
+
+	// one event in the text log format: "[tick] NAME name=value name=value \n"
+	template <class TEvent>
+	void writeEventLine(EventLineBuffer& out, uint64_t tick, TEvent& event)
+	{
+		out.put('[');
+		out.appendValue(tick);
+		out.append("] ");
+		out.append(TEvent::Name);
+		out.put(' ');
+		CharsFieldVisitor visitor(out);
+		event.visit(visitor);
+		out.put('\n');
+	}
+}
@@ -19,6 +19,16 @@ namespace sw
 		{
 			_stream << name << "=" << value << ' ';
 		}
+
+		// optional fields are printed only when set
+		template <typename T>
+		void visitOptional(const char* name, const T& value)
+		{
+			if (value != T{})
+			{
+				visit(name, value);
+			}
+		}
 	};
 
 }
@@ -0,0 +1,99 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "SharedSnapshot.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace sw::observer
+{
+	namespace
+	{
+		std::runtime_error systemError(const std::string& what, const std::string& name)
+		{
+			return std::runtime_error("Error: " + what + " " + name + " - " + std::strerror(errno));
+		}
+	}
+
+	SharedSnapshot SharedSnapshot::create(const std::string& name, uint32_t capacity)
+	{
+		const size_t size = snapshot::segmentSize(capacity);
+		// a segment left by a crashed run would keep its old size and frames
+		shm_unlink(name.c_str());
+		const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+		if (fd < 0)
+		{
+			throw systemError("Cannot create snapshot segment", name);
+		}
+		if (ftruncate(fd, static_cast<off_t>(size)) < 0)
+		{
+			close(fd);
+			shm_unlink(name.c_str());
+			throw systemError("Cannot size snapshot segment", name);
+		}
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (memory == MAP_FAILED)
+		{
+			shm_unlink(name.c_str());
+			throw systemError("Cannot map snapshot segment", name);
+		}
+		return SharedSnapshot(name, memory, size, true);
+	}
+
+	SharedSnapshot SharedSnapshot::open(const std::string& name)
+	{
+		const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+		{
+			throw systemError("Cannot open snapshot segment", name);
+		}
+		struct stat status{};
+		if (fstat(fd, &status) < 0 || static_cast<size_t>(status.st_size) < sizeof(snapshot::SnapshotHeader))
+		{
+			close(fd);
+			throw std::runtime_error("Error: Not a snapshot segment - " + name);
+		}
+		const auto size = static_cast<size_t>(status.st_size);
+		void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (memory == MAP_FAILED)
+		{
+			throw systemError("Cannot map snapshot segment", name);
+		}
+		SharedSnapshot segment(name, memory, size, false);
+		const auto& header = segment.header();
+		if (header.magic != snapshot::SNAPSHOT_MAGIC || header.version != snapshot::SNAPSHOT_VERSION ||
+			size < snapshot::segmentSize(header.capacity))
+		{
+			throw std::runtime_error("Error: Not a snapshot segment - " + name);
+		}
+		return segment;
+	}
+
+	SharedSnapshot::SharedSnapshot(SharedSnapshot&& other) noexcept
+		: name(std::move(other.name)), memory(std::exchange(other.memory, nullptr)), size(other.size), owner(other.owner)
+	{
+	}
+
+	SharedSnapshot::~SharedSnapshot()
+	{
+		if (!memory)
+		{
+			return;
+		}
+		munmap(memory, size);
+		if (owner)
+		{
+			shm_unlink(name.c_str());
+		}
+	}
+}
@@ -0,0 +1,53 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SHAREDSNAPSHOT_HPP
+#define SW_BATTLE_TEST_SHAREDSNAPSHOT_HPP
+
+#include "IO/Snapshot/WorldSnapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace sw::observer
+{
+	inline constexpr const char* DEFAULT_SNAPSHOT_NAME = "/sw_battle_snapshot";
+
+	// POSIX shared memory object holding a snapshot segment (IO/Snapshot/WorldSnapshot.hpp): the engine maps it
+	// writable, every observer process read-only
+	class SharedSnapshot
+	{
+		std::string name;
+		void* memory{nullptr};
+		size_t size{0};
+		bool owner{false};
+
+		SharedSnapshot(std::string name_, void* memory_, size_t size_, bool owner_) noexcept
+			: name(std::move(name_)), memory(memory_), size(size_), owner(owner_)
+		{
+		}
+
+	public:
+		// creates the object for 'capacity' units, replacing a stale one of the same name; the owner removes it
+		// when destroyed, mapped observers keep the last frame
+		static SharedSnapshot create(const std::string& name, uint32_t capacity);
+		// maps an existing object read-only, throws if it is not a snapshot segment
+		static SharedSnapshot open(const std::string& name);
+
+		SharedSnapshot(SharedSnapshot&& other) noexcept;
+		SharedSnapshot& operator=(SharedSnapshot&&) = delete;
+		SharedSnapshot(const SharedSnapshot&) = delete;
+		~SharedSnapshot();
+
+		[[nodiscard]] void* data() const noexcept { return memory; }
+		[[nodiscard]] const snapshot::SnapshotHeader& header() const noexcept
+		{
+			return *static_cast<const snapshot::SnapshotHeader*>(memory);
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SHAREDSNAPSHOT_HPP
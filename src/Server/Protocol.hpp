@@ -0,0 +1,190 @@
+//
+// Created by Carpov Pavel on 23.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_PROTOCOL_HPP
+#define SW_BATTLE_TEST_PROTOCOL_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace sw::server
+{
+	// Wire format of the local simulation server, every message is a frame: [u8 type][u32 LE payload length][payload].
+	// A client sends one request frame (scenario or status query) and reads frames until Done, Status or Error.
+	enum class FrameType : uint8_t
+	{
+		TextScenario = 'T',	  // request: scenario in the commands file format
+		BinaryScenario = 'B', // request: scenario as binary command records (see BinaryCommandVisitors.hpp)
+		StatusQuery = 'Q',	  // request: server state, answered with Status
+		EventChunk = 'E',	  // response: next piece of the event log text
+		Done = 'D',			  // response: RequestStats, last frame of a scenario run
+		Status = 'S',		  // response: ServerStatus
+		Error = 'X'			  // response: error message, last frame
+	};
+
+	inline constexpr uint32_t MAX_FRAME_SIZE = 64u << 20;
+	inline constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/sw_battle.sock";
+
+	struct RequestStats
+	{
+		uint64_t queueWaitNs{0}; // accepted -> picked by a worker
+		uint64_t runNs{0};		 // parse + simulation
+		uint64_t totalNs{0};	 // accepted -> done
+		uint64_t events{0};
+		uint64_t bytes{0};
+		uint32_t queueDepth{0}; // requests waiting when this one was accepted
+		uint32_t rounds{0};
+	};
+
+	struct ServerStatus
+	{
+		uint32_t queueDepth{0};
+		uint32_t busyWorkers{0};
+		uint32_t workers{0};
+		uint64_t completed{0};
+		uint64_t failed{0};
+	};
+
+	// little-endian field packing shared by both sides
+	inline void putU64(std::string& out, uint64_t value)
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	inline uint64_t getU64(const std::string& in, size_t& offset)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < 8 && offset < in.size(); ++i, ++offset)
+		{
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(in[offset])) << (8 * i);
+		}
+		return value;
+	}
+
+	inline std::string encode(const RequestStats& stats)
+	{
+		std::string out;
+		for (uint64_t v : {stats.queueWaitNs, stats.runNs, stats.totalNs, stats.events, stats.bytes,
+				 uint64_t{stats.queueDepth}, uint64_t{stats.rounds}})
+		{
+			putU64(out, v);
+		}
+		return out;
+	}
+
+	inline RequestStats decodeRequestStats(const std::string& in)
+	{
+		size_t offset = 0;
+		RequestStats stats;
+		stats.queueWaitNs = getU64(in, offset);
+		stats.runNs = getU64(in, offset);
+		stats.totalNs = getU64(in, offset);
+		stats.events = getU64(in, offset);
+		stats.bytes = getU64(in, offset);
+		stats.queueDepth = static_cast<uint32_t>(getU64(in, offset));
+		stats.rounds = static_cast<uint32_t>(getU64(in, offset));
+		return stats;
+	}
+
+	inline std::string encode(const ServerStatus& status)
+	{
+		std::string out;
+		for (uint64_t v : {uint64_t{status.queueDepth}, uint64_t{status.busyWorkers}, uint64_t{status.workers},
+				 status.completed, status.failed})
+		{
+			putU64(out, v);
+		}
+		return out;
+	}
+
+	inline ServerStatus decodeServerStatus(const std::string& in)
+	{
+		size_t offset = 0;
+		ServerStatus status;
+		status.queueDepth = static_cast<uint32_t>(getU64(in, offset));
+		status.busyWorkers = static_cast<uint32_t>(getU64(in, offset));
+		status.workers = static_cast<uint32_t>(getU64(in, offset));
+		status.completed = getU64(in, offset);
+		status.failed = getU64(in, offset);
+		return status;
+	}
+
+	inline bool writeAll(int fd, const void* data, size_t size)
+	{
+		const auto* bytes = static_cast<const char*>(data);
+		while (size > 0)
+		{
+			ssize_t written = ::write(fd, bytes, size);
+			if (written < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (written <= 0)
+			{
+				return false;
+			}
+			bytes += written;
+			size -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	inline bool readAll(int fd, void* data, size_t size)
+	{
+		auto* bytes = static_cast<char*>(data);
+		while (size > 0)
+		{
+			ssize_t received = ::read(fd, bytes, size);
+			if (received < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (received <= 0)
+			{
+				return false;
+			}
+			bytes += received;
+			size -= static_cast<size_t>(received);
+		}
+		return true;
+	}
+
+	inline bool writeFrame(int fd, FrameType type, const void* payload, uint32_t size)
+	{
+		unsigned char header[5] = {static_cast<unsigned char>(type), static_cast<unsigned char>(size & 0xFF),
+			static_cast<unsigned char>((size >> 8) & 0xFF), static_cast<unsigned char>((size >> 16) & 0xFF),
+			static_cast<unsigned char>((size >> 24) & 0xFF)};
+		return writeAll(fd, header, sizeof(header)) && (size == 0 || writeAll(fd, payload, size));
+	}
+
+	inline bool writeFrame(int fd, FrameType type, const std::string& payload)
+	{
+		return writeFrame(fd, type, payload.data(), static_cast<uint32_t>(payload.size()));
+	}
+
+	inline bool readFrame(int fd, FrameType& type, std::string& payload)
+	{
+		unsigned char header[5];
+		if (!readAll(fd, header, sizeof(header)))
+		{
+			return false;
+		}
+		const uint32_t size = header[1] | (header[2] << 8) | (header[3] << 16) | (static_cast<uint32_t>(header[4]) << 24);
+		if (size > MAX_FRAME_SIZE)
+		{
+			return false;
+		}
+		type = static_cast<FrameType>(header[0]);
+		payload.resize(size);
+		return size == 0 || readAll(fd, payload.data(), size);
+	}
+}
+
+#endif	//SW_BATTLE_TEST_PROTOCOL_HPP
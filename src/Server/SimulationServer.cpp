@@ -0,0 +1,267 @@
+//
+// Created by Carpov Pavel on 23.10.2025.
+//
+
+#include "SimulationServer.hpp"
+
+#include "Core/Engine/Engine.hpp"
+#include "Core/Engine/Scenario.hpp"
+#include "Core/Units/UnitDefinitions.hpp"
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/un.h>
+
+namespace sw::server
+{
+	namespace
+	{
+		volatile std::sig_atomic_t stopRequested = 0;
+
+		void onStopSignal(int)
+		{
+			stopRequested = 1;
+		}
+
+		uint64_t nanosSince(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+		}
+
+		// Packs the event log into EventChunk frames. Line flushes are ignored, data leaves in full buffers.
+		class FrameStreamBuf : public std::streambuf
+		{
+			int fd;
+			char buffer[64 * 1024];
+			bool broken{false};
+
+			void send()
+			{
+				const auto size = static_cast<uint32_t>(pptr() - pbase());
+				if (size && !broken)
+				{
+					broken = !writeFrame(fd, FrameType::EventChunk, pbase(), size);
+				}
+				setp(buffer, buffer + sizeof(buffer));
+			}
+
+		public:
+			explicit FrameStreamBuf(int fd_) : fd(fd_) { setp(buffer, buffer + sizeof(buffer)); }
+
+			void finish() { send(); }
+			[[nodiscard]] bool isBroken() const noexcept { return broken; }
+
+		protected:
+			int_type overflow(int_type ch) override
+			{
+				send();
+				if (!traits_type::eq_int_type(ch, traits_type::eof()))
+				{
+					*pptr() = traits_type::to_char_type(ch);
+					pbump(1);
+				}
+				return traits_type::not_eof(ch);
+			}
+
+			int sync() override { return 0; }
+		};
+	}
+
+	SimulationServer::SimulationServer(ServerConfig config_) : config(std::move(config_))
+	{
+		if (config.workers == 0)
+		{
+			config.workers = std::max(1u, std::thread::hardware_concurrency());
+		}
+	}
+
+	SimulationServer::~SimulationServer()
+	{
+		if (listenFd >= 0)
+		{
+			::close(listenFd);
+			::unlink(config.socketPath.c_str());
+		}
+	}
+
+	void SimulationServer::run()
+	{
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (config.socketPath.size() >= sizeof(address.sun_path))
+		{
+			throw std::runtime_error("Socket path is too long: " + config.socketPath);
+		}
+		std::strncpy(address.sun_path, config.socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+		listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listenFd < 0)
+		{
+			throw std::runtime_error("socket() failed: " + std::string(std::strerror(errno)));
+		}
+		::unlink(config.socketPath.c_str()); // stale socket from a previous run
+		if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listenFd, 128) < 0)
+		{
+			throw std::runtime_error("Cannot listen on " + config.socketPath + ": " + std::strerror(errno));
+		}
+
+		// no SA_RESTART: a stop signal must interrupt accept()
+		struct sigaction action{};
+		action.sa_handler = onStopSignal;
+		sigemptyset(&action.sa_mask);
+		::sigaction(SIGINT, &action, nullptr);
+		::sigaction(SIGTERM, &action, nullptr);
+		std::signal(SIGPIPE, SIG_IGN); // clients may hang up mid-stream
+
+		for (uint32_t i = 0; i < config.workers; ++i)
+		{
+			workers.emplace_back(&SimulationServer::workerLoop, this);
+		}
+		std::cerr << "Serving on " << config.socketPath << " with " << config.workers << " workers\n";
+
+		uint64_t nextId = 1;
+		while (!stopRequested)
+		{
+			int fd = ::accept(listenFd, nullptr, nullptr);
+			if (fd < 0)
+			{
+				continue; // EINTR on stop, or a transient error
+			}
+			// a silent client must not block the acceptor forever
+			timeval timeout{5, 0};
+			::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+			Job job;
+			job.id = nextId++;
+			job.fd = fd;
+			job.accepted = std::chrono::steady_clock::now();
+			if (!readFrame(fd, job.kind, job.payload))
+			{
+				::close(fd);
+				continue;
+			}
+			if (job.kind == FrameType::StatusQuery)
+			{
+				writeFrame(fd, FrameType::Status, encode(getStatus()));
+				::close(fd);
+				continue;
+			}
+			if (job.kind != FrameType::TextScenario && job.kind != FrameType::BinaryScenario)
+			{
+				writeFrame(fd, FrameType::Error, std::string("Unexpected request frame"));
+				::close(fd);
+				continue;
+			}
+			{
+				std::lock_guard lock(queueMutex);
+				job.queueDepth = static_cast<uint32_t>(queue.size());
+				queue.push_back(std::move(job));
+			}
+			queueCondition.notify_one();
+		}
+
+		{
+			std::lock_guard lock(queueMutex);
+			stopping = true;
+		}
+		queueCondition.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		std::cerr << "Server stopped, " << completed << " requests completed, " << failed << " failed\n";
+	}
+
+	ServerStatus SimulationServer::getStatus()
+	{
+		ServerStatus status;
+		{
+			std::lock_guard lock(queueMutex);
+			status.queueDepth = static_cast<uint32_t>(queue.size());
+		}
+		status.busyWorkers = busyWorkers;
+		status.workers = config.workers;
+		status.completed = completed;
+		status.failed = failed;
+		return status;
+	}
+
+	void SimulationServer::workerLoop()
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock lock(queueMutex);
+				queueCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+				if (queue.empty())
+				{
+					return; // stopping and drained
+				}
+				job = std::move(queue.front());
+				queue.pop_front();
+			}
+			++busyWorkers;
+			runJob(job);
+			--busyWorkers;
+			::close(job.fd);
+		}
+	}
+
+	void SimulationServer::runJob(Job& job)
+	{
+		const auto started = std::chrono::steady_clock::now();
+		RequestStats stats;
+		stats.queueWaitNs = nanosSince(job.accepted, started);
+		stats.queueDepth = job.queueDepth;
+
+		FrameStreamBuf frames(job.fd);
+		std::ostream eventStream(&frames);
+		std::string error;
+		try
+		{
+			// every request gets its own engine, nothing is shared between runs
+			core::Engine engine(eventStream);
+			engine.setRoundDelay(std::chrono::milliseconds(0));
+			engine.setRoundLimit(config.roundLimit);
+
+			std::istringstream input(job.payload, std::ios::in | std::ios::binary);
+			const auto scenario = job.kind == FrameType::BinaryScenario ? core::Scenario::parseBinary(input, config.units)
+																		: core::Scenario::parse(input, nullptr, config.units);
+			scenario.applyTo(engine);
+			engine.simulateRounds();
+
+			stats.rounds = engine.getRound();
+			stats.events = engine.getEventLog().getEventsLogged();
+			stats.bytes = engine.getEventLog().getBytesLogged();
+		}
+		catch (const std::exception& e)
+		{
+			error = e.what();
+		}
+		frames.finish();
+
+		const auto finished = std::chrono::steady_clock::now();
+		stats.runNs = nanosSince(started, finished);
+		stats.totalNs = nanosSince(job.accepted, finished);
+		if (error.empty())
+		{
+			writeFrame(job.fd, FrameType::Done, encode(stats));
+			++completed;
+		}
+		else
+		{
+			writeFrame(job.fd, FrameType::Error, error);
+			++failed;
+		}
+
+		std::lock_guard lock(logMutex);
+		std::cerr << "request #" << job.id << (error.empty() ? " done" : " failed: " + error) << ", queue depth "
+				  << stats.queueDepth << ", wait " << stats.queueWaitNs / 1000 << " us, run " << stats.runNs / 1000
+				  << " us, total " << stats.totalNs / 1000 << " us, " << stats.events << " events"
+				  << (frames.isBroken() ? ", client disconnected" : "") << '\n';
+	}
+}
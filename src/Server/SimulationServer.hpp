@@ -0,0 +1,79 @@
+//
+// Created by Carpov Pavel on 23.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SIMULATIONSERVER_HPP
+#define SW_BATTLE_TEST_SIMULATIONSERVER_HPP
+
+#include "Protocol.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sw::core
+{
+	class UnitDefinitions;
+}
+
+namespace sw::server
+{
+	struct ServerConfig
+	{
+		std::string socketPath{DEFAULT_SOCKET_PATH};
+		uint32_t workers{0};	// 0 = hardware concurrency
+		uint32_t roundLimit{0}; // per request, 0 = unlimited
+		std::shared_ptr<const core::UnitDefinitions> units; // kinds requests may spawn besides the built-in ones
+	};
+
+	// Long-running simulation service on a Unix domain socket. The acceptor thread reads one request frame per
+	// connection and queues it; workers run every request on its own Engine and stream the event log back.
+	class SimulationServer
+	{
+		struct Job
+		{
+			uint64_t id{0};
+			int fd{-1};
+			FrameType kind{FrameType::TextScenario};
+			std::string payload;
+			std::chrono::steady_clock::time_point accepted;
+			uint32_t queueDepth{0};
+		};
+
+		ServerConfig config;
+		int listenFd{-1};
+		std::vector<std::thread> workers;
+
+		std::mutex queueMutex;
+		std::condition_variable queueCondition;
+		std::deque<Job> queue;
+		bool stopping{false};
+
+		std::atomic<uint32_t> busyWorkers{0};
+		std::atomic<uint64_t> completed{0};
+		std::atomic<uint64_t> failed{0};
+		std::mutex logMutex;
+
+		void workerLoop();
+		void runJob(Job& job);
+		[[nodiscard]] ServerStatus getStatus();
+
+	public:
+		explicit SimulationServer(ServerConfig config_);
+		~SimulationServer();
+		SimulationServer(const SimulationServer&) = delete;
+		SimulationServer& operator=(const SimulationServer&) = delete;
+
+		// binds the socket and serves until SIGINT/SIGTERM
+		void run();
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SIMULATIONSERVER_HPP
@@ -0,0 +1,436 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#include "ShardRunner.hpp"
+
+#include "ShmRing.hpp"
+
+#include "Core/Engine/Engine.hpp"
+#include "Core/Engine/Scenario.hpp"
+#include "Core/Engine/ShardTransport.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace sw::shard
+{
+	namespace
+	{
+		// shard i > 0 plays with seed ^ (i * SEED_SPREAD), shard 0 with the seed itself
+		constexpr uint64_t SEED_SPREAD = 0x9E3779B97F4A7C15ull;
+
+		// thrown in a shard that sees another one fail, it exits without a message of its own
+		struct ShardAborted
+		{
+		};
+
+		// start of the shared mapping: barrier, abort flag and the outcome written by shard 0;
+		// one reduce slot per shard follows, then the rings
+		struct ShardBoard
+		{
+			alignas(64) std::atomic<uint32_t> arrived{0};
+			alignas(64) std::atomic<uint32_t> generation{0};
+			alignas(64) std::atomic<uint32_t> failed{0};
+			uint32_t shards{0};
+			uint32_t rounds{0};
+			uint32_t survivors{0};
+			uint64_t finalHash{0};
+		};
+
+		size_t roundUp(size_t bytes) noexcept { return (bytes + 63) / 64 * 64; }
+
+		// offsets of everything in the mapping, every process computes the same ones from the grid
+		struct SharedLayout
+		{
+			std::vector<std::vector<uint32_t>> neighbours; // per shard, ShardLayout::neighboursOf
+			std::vector<std::vector<size_t>> rings; // [shard][neighbour slot]: ring from the shard to that neighbour
+			size_t totalsOffset{0};
+			size_t bytes{0};
+
+			SharedLayout(const core::ShardConfig& grid, size_t ringBytes)
+			{
+				const uint32_t shards = grid.columns * grid.rows;
+				totalsOffset = roundUp(sizeof(ShardBoard));
+				bytes = totalsOffset + roundUp(sizeof(core::ShardTotals) * shards);
+				for (uint32_t shard = 0; shard < shards; ++shard)
+				{
+					neighbours.push_back(core::ShardLayout::neighboursOf(grid.columns, grid.rows, shard));
+					rings.emplace_back();
+					for (size_t slot = 0; slot < neighbours.back().size(); ++slot)
+					{
+						rings.back().push_back(bytes);
+						bytes += ShmRing::footprint(ringBytes);
+					}
+				}
+			}
+
+			// ring the neighbour at 'slot' of the shard writes to the shard
+			[[nodiscard]] size_t ringTo(uint32_t shard, size_t slot) const
+			{
+				const uint32_t from = neighbours[shard][slot];
+				const auto& back = neighbours[from];
+				return rings[from][static_cast<size_t>(std::find(back.begin(), back.end(), shard) - back.begin())];
+			}
+		};
+
+		// Shard link over the shared mapping. Messages are framed as [u64 length][bytes]; an exchange pushes and
+		// pulls all of them in one loop, so a message longer than its ring never blocks the neighbours
+		class ShmShardTransport final : public core::ShardTransport
+		{
+			struct Inbox
+			{
+				uint64_t length{0};
+				size_t offset{0}; // frame bytes received, header included
+			};
+
+			ShardBoard& board;
+			core::ShardTotals* totals;
+			uint32_t index;
+			std::vector<ShmRing*> out;
+			std::vector<ShmRing*> in;
+			std::vector<size_t> sent;
+			std::vector<Inbox> inboxes;
+
+			void idle() const
+			{
+				if (board.failed.load(std::memory_order_acquire))
+				{
+					throw ShardAborted{};
+				}
+				sched_yield();
+			}
+
+			// sense-reversing barrier: the last one to arrive opens the next generation
+			void barrier() const
+			{
+				const uint32_t generation = board.generation.load(std::memory_order_acquire);
+				if (board.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == board.shards)
+				{
+					board.arrived.store(0, std::memory_order_relaxed);
+					board.generation.fetch_add(1, std::memory_order_release);
+					return;
+				}
+				while (board.generation.load(std::memory_order_acquire) == generation)
+				{
+					idle();
+				}
+			}
+
+			// sends what fits of the frame from 'offset' on, returns the new offset
+			static size_t sendFrame(ShmRing& ring, const std::string& message, size_t offset)
+			{
+				const uint64_t length = message.size();
+				if (offset < sizeof(length))
+				{
+					offset += ring.write(reinterpret_cast<const char*>(&length) + offset, sizeof(length) - offset);
+				}
+				if (offset >= sizeof(length))
+				{
+					const size_t body = offset - sizeof(length);
+					offset += ring.write(message.data() + body, message.size() - body);
+				}
+				return offset;
+			}
+			static void receiveFrame(ShmRing& ring, std::string& message, Inbox& inbox)
+			{
+				if (inbox.offset < sizeof(inbox.length))
+				{
+					inbox.offset += ring.read(reinterpret_cast<char*>(&inbox.length) + inbox.offset, sizeof(inbox.length) - inbox.offset);
+					if (inbox.offset < sizeof(inbox.length))
+					{
+						return;
+					}
+					message.resize(inbox.length);
+				}
+				const size_t body = inbox.offset - sizeof(inbox.length);
+				inbox.offset += ring.read(message.data() + body, inbox.length - body);
+			}
+
+		public:
+			ShmShardTransport(char* shared, const SharedLayout& layout, uint32_t index_)
+				: board(*reinterpret_cast<ShardBoard*>(shared)),
+				  totals(reinterpret_cast<core::ShardTotals*>(shared + layout.totalsOffset)), index(index_)
+			{
+				for (size_t slot = 0; slot < layout.neighbours[index].size(); ++slot)
+				{
+					out.push_back(reinterpret_cast<ShmRing*>(shared + layout.rings[index][slot]));
+					in.push_back(reinterpret_cast<ShmRing*>(shared + layout.ringTo(index, slot)));
+				}
+				sent.resize(out.size());
+				inboxes.resize(in.size());
+			}
+
+			void exchange(const std::vector<std::string>& outgoing, std::vector<std::string>& incoming) override
+			{
+				incoming.resize(in.size());
+				std::fill(sent.begin(), sent.end(), 0);
+				std::fill(inboxes.begin(), inboxes.end(), Inbox{});
+				bool done = false;
+				while (!done)
+				{
+					done = true;
+					bool progress = false;
+					for (size_t slot = 0; slot < out.size(); ++slot)
+					{
+						const size_t frame = sizeof(uint64_t) + outgoing[slot].size();
+						if (sent[slot] < frame)
+						{
+							const size_t before = sent[slot];
+							sent[slot] = sendFrame(*out[slot], outgoing[slot], sent[slot]);
+							progress |= sent[slot] != before;
+							done &= sent[slot] == frame;
+						}
+						Inbox& inbox = inboxes[slot];
+						if (inbox.offset < sizeof(uint64_t) || inbox.offset < sizeof(uint64_t) + inbox.length)
+						{
+							const size_t before = inbox.offset;
+							receiveFrame(*in[slot], incoming[slot], inbox);
+							progress |= inbox.offset != before;
+							done &= inbox.offset >= sizeof(uint64_t) && inbox.offset == sizeof(uint64_t) + inbox.length;
+						}
+					}
+					if (!done && !progress)
+					{
+						idle();
+					}
+				}
+			}
+
+			core::ShardTotals reduce(const core::ShardTotals& local) override
+			{
+				totals[index] = local;
+				barrier();
+				core::ShardTotals sum;
+				for (uint32_t shard = 0; shard < board.shards; ++shard)
+				{
+					sum.add(totals[shard]);
+				}
+				// nobody writes the next totals before everyone has read these
+				barrier();
+				return sum;
+			}
+		};
+
+		std::string makeLogPath()
+		{
+			const char* dir = std::getenv("TMPDIR");
+			std::string path = std::string(dir && *dir ? dir : "/tmp") + "/sw_shard_XXXXXX";
+			const int fd = mkstemp(path.data());
+			if (fd < 0)
+			{
+				throw std::runtime_error("Error: Cannot create a shard log - " + std::string(std::strerror(errno)));
+			}
+			close(fd);
+			return path;
+		}
+
+		// body of a shard process, never returns
+		[[noreturn]] void playShard(const core::Scenario& scenario, const ShardRunConfig& config, uint64_t seed,
+			uint32_t index, char* shared, const SharedLayout& layout, const std::string& logPath)
+		{
+			auto& board = *reinterpret_cast<ShardBoard*>(shared);
+			int status = 0;
+			try
+			{
+				std::ofstream log(logPath, std::ios::binary | std::ios::trunc);
+				if (!log)
+				{
+					throw std::runtime_error("cannot write " + logPath);
+				}
+				core::ShardConfig shardConfig = config.grid;
+				shardConfig.index = index;
+				ShmShardTransport transport(shared, layout, index);
+				core::Engine engine(log);
+				engine.setSeed(index == 0 ? seed : seed ^ (index * SEED_SPREAD));
+				if (config.textEvents)
+				{
+					engine.getEventLog().setTextEvents(*config.textEvents);
+				}
+				engine.setWorldHashEvents(config.worldHashEvents);
+				engine.setShard(shardConfig, transport);
+				scenario.applyTo(engine);
+				engine.setRoundLimit(config.roundLimit);
+				engine.setRoundDelay(std::chrono::milliseconds(0));
+				engine.simulateRounds();
+				log.close();
+				if (index == 0)
+				{
+					board.rounds = engine.getRound();
+					board.survivors = engine.getSurvivors();
+					board.finalHash = engine.getFinalHash();
+				}
+			}
+			catch (const ShardAborted&)
+			{
+				status = 2;
+			}
+			catch (const std::exception& e)
+			{
+				// all shards handle the same scenario, most errors are met by all of them: report the first one
+				if (board.failed.exchange(1, std::memory_order_acq_rel) == 0)
+				{
+					std::cerr << "Shard " << index << ": " << e.what() << std::endl;
+				}
+				status = 1;
+			}
+			// the parent's buffers and atexit handlers are not ours
+			_exit(status);
+		}
+
+		// lines ordered by round, within a round shard by shard, each log in its own order
+		void mergeLogs(const std::vector<std::string>& paths, std::ostream& events)
+		{
+			std::vector<std::ifstream> logs;
+			std::vector<std::string> heads(paths.size());
+			std::vector<bool> pending(paths.size());
+			for (size_t shard = 0; shard < paths.size(); ++shard)
+			{
+				logs.emplace_back(paths[shard], std::ios::binary);
+				pending[shard] = static_cast<bool>(std::getline(logs[shard], heads[shard]));
+			}
+			const auto tickOf = [](const std::string& line) { return std::strtoull(line.c_str() + 1, nullptr, 10); };
+			while (true)
+			{
+				std::optional<uint64_t> tick;
+				for (size_t shard = 0; shard < paths.size(); ++shard)
+				{
+					if (pending[shard] && (!tick || tickOf(heads[shard]) < *tick))
+					{
+						tick = tickOf(heads[shard]);
+					}
+				}
+				if (!tick)
+				{
+					break;
+				}
+				for (size_t shard = 0; shard < paths.size(); ++shard)
+				{
+					while (pending[shard] && tickOf(heads[shard]) == *tick)
+					{
+						events << heads[shard] << '\n';
+						pending[shard] = static_cast<bool>(std::getline(logs[shard], heads[shard]));
+					}
+				}
+			}
+			events.flush();
+		}
+	}
+
+	ShardRunResult runShards(const core::Scenario& scenario, const ShardRunConfig& config, std::ostream& events)
+	{
+		const auto started = std::chrono::steady_clock::now();
+		const uint32_t shards = config.grid.columns * config.grid.rows;
+		if (shards == 0 || config.ringBytes == 0)
+		{
+			throw std::runtime_error("Error: Empty shard grid");
+		}
+		const uint64_t seed = config.seed.value_or(static_cast<uint64_t>(std::random_device{}()));
+		const SharedLayout layout(config.grid, config.ringBytes);
+
+		void* mapping = mmap(nullptr, layout.bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (mapping == MAP_FAILED)
+		{
+			throw std::runtime_error("Error: Cannot map shard memory - " + std::string(std::strerror(errno)));
+		}
+		char* shared = static_cast<char*>(mapping);
+		auto* board = new (shared) ShardBoard;
+		board->shards = shards;
+		for (uint32_t shard = 0; shard < shards; ++shard)
+		{
+			new (shared + layout.totalsOffset + shard * sizeof(core::ShardTotals)) core::ShardTotals;
+			for (const size_t offset : layout.rings[shard])
+			{
+				new (shared + offset) ShmRing(config.ringBytes);
+			}
+		}
+
+		std::vector<std::string> logPaths;
+		bool failed = false;
+		try
+		{
+			for (uint32_t shard = 0; shard < shards; ++shard)
+			{
+				logPaths.push_back(makeLogPath());
+			}
+		}
+		catch (...)
+		{
+			for (const auto& path : logPaths)
+			{
+				std::remove(path.c_str());
+			}
+			munmap(mapping, layout.bytes);
+			throw;
+		}
+
+		// children inherit unflushed buffers
+		std::cout.flush();
+		std::cerr.flush();
+		events.flush();
+		uint32_t running = 0;
+		for (uint32_t shard = 0; shard < shards; ++shard)
+		{
+			const pid_t pid = fork();
+			if (pid == 0)
+			{
+				playShard(scenario, config, seed, shard, shared, layout, logPaths[shard]);
+			}
+			if (pid < 0)
+			{
+				board->failed.store(1, std::memory_order_release);
+				failed = true;
+				break;
+			}
+			++running;
+		}
+		// any failed shard releases the others from their waits
+		for (; running > 0; --running)
+		{
+			int status = 0;
+			if (waitpid(-1, &status, 0) < 0)
+			{
+				failed = true;
+				break;
+			}
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			{
+				board->failed.store(1, std::memory_order_release);
+				failed = true;
+			}
+		}
+
+		ShardRunResult result;
+		result.rounds = board->rounds;
+		result.survivors = board->survivors;
+		result.finalHash = board->finalHash;
+		munmap(mapping, layout.bytes);
+		if (!failed)
+		{
+			mergeLogs(logPaths, events);
+		}
+		for (const auto& path : logPaths)
+		{
+			std::remove(path.c_str());
+		}
+		if (failed)
+		{
+			throw std::runtime_error("Error: Sharded run failed");
+		}
+		result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+		return result;
+	}
+}
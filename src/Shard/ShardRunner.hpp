@@ -0,0 +1,51 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SHARDRUNNER_HPP
+#define SW_BATTLE_TEST_SHARDRUNNER_HPP
+
+#include "Core/Engine/ShardLayout.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sw::core
+{
+	class Scenario;
+}
+
+namespace sw::shard
+{
+	// bytes of every ring between two neighbours, a larger message just takes more passes
+	inline constexpr size_t DEFAULT_RING_BYTES = 1 << 20;
+
+	struct ShardRunConfig
+	{
+		core::ShardConfig grid; // columns, rows and halo; the index is set per shard
+		std::optional<uint64_t> seed; // shard 0 plays with it, the others with seeds derived from it
+		uint32_t roundLimit{0};
+		std::optional<std::vector<std::string>> textEvents;
+		bool worldHashEvents{false};
+		size_t ringBytes{DEFAULT_RING_BYTES};
+	};
+
+	struct ShardRunResult
+	{
+		uint32_t rounds{0};
+		uint32_t survivors{0};
+		uint64_t finalHash{0};
+		std::chrono::milliseconds elapsed{0};
+	};
+
+	// Plays one battle split over columns x rows processes. Each process runs its own Engine on one region and
+	// talks to its neighbours through lock-free rings in a shared anonymous mapping; the event logs of all shards
+	// are merged into 'events' by round, then by shard. Throws if a shard fails.
+	ShardRunResult runShards(const core::Scenario& scenario, const ShardRunConfig& config, std::ostream& events);
+}
+
+#endif	//SW_BATTLE_TEST_SHARDRUNNER_HPP
@@ -0,0 +1,64 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+#ifndef SW_BATTLE_TEST_SHMRING_HPP
+#define SW_BATTLE_TEST_SHMRING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace sw::shard
+{
+	// Single-producer single-consumer byte ring placed in memory shared by two processes, its data follows the
+	// header. Both positions only grow: the producer publishes bytes with a release store of 'head', the consumer
+	// frees them with a release store of 'tail'. No locks, no system calls.
+	class ShmRing
+	{
+		static_assert(std::atomic<uint64_t>::is_always_lock_free, "ShmRing: atomics must work across processes");
+
+		alignas(64) std::atomic<uint64_t> head{0}; // bytes written, owned by the producer
+		alignas(64) std::atomic<uint64_t> tail{0}; // bytes read, owned by the consumer
+		alignas(64) uint64_t capacity;
+
+		char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+
+	public:
+		explicit ShmRing(uint64_t capacity_) noexcept : capacity(capacity_) {}
+
+		// bytes of shared memory a ring of this capacity takes, a multiple of 64
+		static size_t footprint(uint64_t capacity_) noexcept { return sizeof(ShmRing) + (capacity_ + 63) / 64 * 64; }
+
+		// writes as much as fits, returns the number of bytes written
+		size_t write(const char* bytes, size_t size) noexcept
+		{
+			const uint64_t written = head.load(std::memory_order_relaxed);
+			const uint64_t read = tail.load(std::memory_order_acquire);
+			const size_t count = std::min<uint64_t>(size, capacity - (written - read));
+			const size_t at = written % capacity;
+			const size_t first = std::min<size_t>(count, capacity - at);
+			std::memcpy(data() + at, bytes, first);
+			std::memcpy(data(), bytes + first, count - first);
+			head.store(written + count, std::memory_order_release);
+			return count;
+		}
+		// reads what is available up to 'size', returns the number of bytes read
+		size_t read(char* bytes, size_t size) noexcept
+		{
+			const uint64_t read = tail.load(std::memory_order_relaxed);
+			const uint64_t written = head.load(std::memory_order_acquire);
+			const size_t count = std::min<uint64_t>(size, written - read);
+			const size_t at = read % capacity;
+			const size_t first = std::min<size_t>(count, capacity - at);
+			std::memcpy(bytes, data() + at, first);
+			std::memcpy(bytes + first, data(), count - first);
+			tail.store(read + count, std::memory_order_release);
+			return count;
+		}
+	};
+}
+
+#endif	//SW_BATTLE_TEST_SHMRING_HPP
@@ -1,90 +1,437 @@
-#include "IO/Commands/CreateMap.hpp"
-#include "IO/Commands/March.hpp"
-#include "IO/Commands/SpawnSwordsman.hpp"
-#include "IO/Commands/SpawnHunter.hpp"
-#include "IO/Commands/SpawnMine.hpp"
-#include "IO/Commands/SpawnHealer.hpp"
-
+#include <Core/Engine/BatchRunner.hpp>
 #include <Core/Engine/Engine.hpp>
-#include <IO/System/CommandParser.hpp>
-#include <IO/System/PrintDebug.hpp>
+#include <Core/Engine/Profiler.hpp>
+#include <Core/Engine/Scenario.hpp>
+#include <Core/Units/UnitDefinitions.hpp>
+#include <IO/Archive/EventArchive.hpp>
+#if defined(__unix__) || defined(__APPLE__)
+#include <Server/SimulationServer.hpp>
+#include <Observer/SharedSnapshot.hpp>
+#include <Shard/ShardRunner.hpp>
+#endif
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
 #include <vector>
-#include <functional>
 
 int main(int argc, char** argv)
 {
     using namespace sw;
 
-    if (argc != 2)
+    // usage: sw_battle_test [--profile[=report.json]] [--trace[=trace.json]] [--render[=x,y,w,h[,zoom]]]
+    //                       [--round-delay=ms] [--events=NAME,...] [--archive=path] [--seed=N] [--world-hash]
+    //                       [--snapshot[=shm name]] [--alloc-report] [--strict-alloc[=warmup rounds]] <commands file>
+    //        sw_battle_test --runs=N [--seed=N] [--cache=entries] [--threads=N] [--stats[=stats.json]]
+    //                       [--max-rounds=N] <commands file>
+    //        sw_battle_test --serve[=socket path] [--workers=N] [--max-rounds=N]
+    //        sw_battle_test --shards=CxR [--halo=cells] [--events=NAME,...] [--seed=N] [--world-hash]
+    //                       [--max-rounds=N] <commands file>
+    // --max-rounds also applies to a local run, --units=definitions file to every mode
+    std::string scenarioPath;
+    std::string profileReportPath;
+    std::string tracePath;
+    bool render = false;
+    std::optional<Viewport> viewport;
+    std::optional<uint32_t> roundDelayMs;
+    bool serve = false;
+    std::string socketPath;
+    uint32_t workers = 0;
+    uint32_t maxRounds = 0;
+    std::optional<std::vector<std::string>> textEvents;
+    std::string archivePath;
+    std::optional<uint64_t> seed;
+    bool worldHashEvents = false;
+    uint32_t runs = 0;
+    size_t cacheEntries = 1 << 16;
+    uint32_t threads = 1;
+    std::string statsPath;
+    std::shared_ptr<const core::UnitDefinitions> units;
+    std::optional<core::ShardConfig> shardGrid;
+    uint32_t halo = core::DEFAULT_SHARD_HALO;
+    bool allocationReport = false;
+    std::optional<uint32_t> strictAllocationsAfter;
+    bool publishSnapshot = false;
+    std::string snapshotName; // observer::DEFAULT_SNAPSHOT_NAME when empty
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--profile")
+        {
+            profileReportPath = "profile.json";
+        }
+        else if (arg.rfind("--profile=", 0) == 0)
+        {
+            profileReportPath = arg.substr(std::string("--profile=").size());
+        }
+        else if (arg == "--trace")
+        {
+            tracePath = "trace.json";
+        }
+        else if (arg.rfind("--trace=", 0) == 0)
+        {
+            tracePath = arg.substr(std::string("--trace=").size());
+        }
+        else if (arg == "--render")
+        {
+            render = true;
+        }
+        else if (arg.rfind("--render=", 0) == 0)
+        {
+            // viewport as x,y,width,height[,zoom] in world cells / screen cells
+            Viewport v;
+            char comma;
+            std::istringstream spec(arg.substr(std::string("--render=").size()));
+            if (!(spec >> v.x >> comma >> v.y >> comma >> v.width >> comma >> v.height))
+            {
+                throw std::runtime_error("Error: Bad viewport, expected --render=x,y,width,height[,zoom] - " + arg);
+            }
+            if (spec >> comma)
+            {
+                spec >> v.zoom;
+            }
+            render = true;
+            viewport = v;
+        }
+        else if (arg.rfind("--round-delay=", 0) == 0)
+        {
+            roundDelayMs = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--round-delay=").size())));
+        }
+        else if (arg == "--serve")
+        {
+            serve = true;
+        }
+        else if (arg.rfind("--serve=", 0) == 0)
+        {
+            serve = true;
+            socketPath = arg.substr(std::string("--serve=").size());
+        }
+        else if (arg.rfind("--workers=", 0) == 0)
+        {
+            workers = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--workers=").size())));
+        }
+        else if (arg.rfind("--max-rounds=", 0) == 0)
+        {
+            maxRounds = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--max-rounds=").size())));
+        }
+        else if (arg.rfind("--events=", 0) == 0)
+        {
+            // only these event types are printed, the others are not even built
+            textEvents.emplace();
+            std::istringstream names(arg.substr(std::string("--events=").size()));
+            for (std::string name; std::getline(names, name, ',');)
+            {
+                if (!name.empty())
+                {
+                    textEvents->push_back(name);
+                }
+            }
+        }
+        else if (arg.rfind("--archive=", 0) == 0)
+        {
+            archivePath = arg.substr(std::string("--archive=").size());
+        }
+        else if (arg.rfind("--seed=", 0) == 0)
+        {
+            seed = std::stoull(arg.substr(std::string("--seed=").size()));
+        }
+        else if (arg == "--world-hash")
+        {
+            worldHashEvents = true;
+        }
+        else if (arg.rfind("--runs=", 0) == 0)
+        {
+            runs = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--runs=").size())));
+        }
+        else if (arg.rfind("--cache=", 0) == 0)
+        {
+            // 0 disables the transposition cache of a batch
+            cacheEntries = std::stoull(arg.substr(std::string("--cache=").size()));
+        }
+        else if (arg.rfind("--threads=", 0) == 0)
+        {
+            threads = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--threads=").size())));
+        }
+        else if (arg == "--stats")
+        {
+            statsPath = "stats.json";
+        }
+        else if (arg.rfind("--stats=", 0) == 0)
+        {
+            statsPath = arg.substr(std::string("--stats=").size());
+        }
+        else if (arg.rfind("--units=", 0) == 0)
+        {
+            units = std::make_shared<const core::UnitDefinitions>(
+                core::UnitDefinitions::loadFile(arg.substr(std::string("--units=").size())));
+        }
+        else if (arg.rfind("--shards=", 0) == 0)
+        {
+            shardGrid = core::parseShardGrid(arg.substr(std::string("--shards=").size()));
+        }
+        else if (arg.rfind("--halo=", 0) == 0)
+        {
+            halo = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--halo=").size())));
+        }
+        else if (arg == "--alloc-report")
+        {
+            allocationReport = true;
+        }
+        else if (arg == "--strict-alloc")
+        {
+            strictAllocationsAfter = core::DEFAULT_ALLOCATION_WARMUP;
+        }
+        else if (arg.rfind("--strict-alloc=", 0) == 0)
+        {
+            strictAllocationsAfter = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--strict-alloc=").size())));
+        }
+        else if (arg == "--snapshot")
+        {
+            publishSnapshot = true;
+        }
+        else if (arg.rfind("--snapshot=", 0) == 0)
+        {
+            publishSnapshot = true;
+            snapshotName = arg.substr(std::string("--snapshot=").size());
+        }
+        else if (arg.rfind("--", 0) == 0)
+        {
+            throw std::runtime_error("Error: Unknown option - " + arg);
+        }
+        else
+        {
+            scenarioPath = arg;
+        }
+    }
+    if (serve)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        server::ServerConfig config;
+        if (!socketPath.empty())
+        {
+            config.socketPath = socketPath;
+        }
+        config.workers = workers;
+        config.roundLimit = maxRounds;
+        config.units = units;
+        server::SimulationServer(config).run();
+        return 0;
+#else
+        throw std::runtime_error("Error: --serve requires Unix domain sockets");
+#endif
+    }
+    if (scenarioPath.empty())
     {
         throw std::runtime_error("Error: No file specified in command line argument");
     }
 
-    std::ifstream file(argv[1]);
+    if (shardGrid)
+    {
+        // every shard is a process of its own: options needing the whole battle in one place do not apply
+        const std::pair<bool, const char*> conflicts[] = {{runs != 0, "--runs"}, {render, "--render"},
+            {!archivePath.empty(), "--archive"}, {!tracePath.empty(), "--trace"}, {!profileReportPath.empty(), "--profile"},
+            {publishSnapshot, "--snapshot"}, {allocationReport, "--alloc-report"},
+            {strictAllocationsAfter.has_value(), "--strict-alloc"}};
+        for (const auto& [given, option] : conflicts)
+        {
+            if (given)
+            {
+                throw std::runtime_error(std::string("Error: --shards cannot be combined with ") + option);
+            }
+        }
+    }
+
+    std::ifstream file(scenarioPath);
     if (!file)
     {
-        throw std::runtime_error("Error: File not found - " + std::string(argv[1]));
+        throw std::runtime_error("Error: File not found - " + scenarioPath);
     }
 
     std::cout << "Commands:\n";
-    io::CommandParser parser;
-    core::Engine engine;
+    // commands are printed while parsed and executed after "Events:", a batch replays them into every run
+    const auto scenario = core::Scenario::parse(file, &std::cout, units);
+
+    if (runs && (publishSnapshot || allocationReport || strictAllocationsAfter))
+    {
+        throw std::runtime_error("Error: --snapshot, --alloc-report and --strict-alloc apply to a single run, not --runs");
+    }
+    if (runs)
+    {
+        // batch: the same scenario with consecutive seeds, one result line per run instead of the event log
+        core::BatchConfig config;
+        config.runs = runs;
+        config.firstSeed = seed.value_or(static_cast<uint64_t>(std::random_device{}()));
+        config.threads = threads;
+        config.cacheEntries = cacheEntries;
+        config.roundLimit = maxRounds;
+        config.collectStats = !statsPath.empty();
+        const auto batch = core::runBatch(scenario, config);
 
-    // Collect parsed commands and execute them after printing Events
-    std::vector<std::function<void()>> pendingCommands;
-
-    // For each command type: print it during parse, but defer execution
-    parser.add<io::CreateMap>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    })
-    .add<io::SpawnSwordsman>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    })
-    .add<io::SpawnHunter>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    })
-    .add<io::SpawnMine>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    })
-    .add<io::SpawnHealer>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    })
-    .add<io::March>([&pendingCommands, &engine](auto command) {
-        printDebug(std::cout, command);
-        pendingCommands.push_back([&engine, c = std::move(command)]() mutable {
-            engine.handleCommand(std::move(c));
-        });
-    });
-
-    // Parse file: handlers will print commands and enqueue deferred actions
-    parser.parse(file);
+        std::cout << "\n\nRuns:\n";
+        uint32_t resolvedFromCache = 0;
+        for (const auto& run : batch.runs)
+        {
+            resolvedFromCache += run.cached ? 1 : 0;
+            std::cout << "seed=" << run.seed << " rounds=" << run.rounds << " survivors=" << run.survivors
+                      << " hash=" << run.finalHash << (run.cached ? " cached" : "") << '\n';
+        }
+        std::cerr << "Batch: " << runs << " runs on " << batch.threads << " threads in " << batch.elapsed.count()
+                  << " ms, " << resolvedFromCache << " stopped at a cached state";
+        if (cacheEntries && !config.collectStats)
+        {
+            std::cerr << ", cache " << cacheEntries << " entries per thread, " << batch.cacheHits << " hits, "
+                      << batch.cacheMisses << " misses, " << batch.cacheStores << " stores";
+        }
+        std::cerr << '\n';
+        if (config.collectStats)
+        {
+            std::ofstream statsFile(statsPath);
+            if (!statsFile)
+            {
+                throw std::runtime_error("Error: Cannot create stats file - " + statsPath);
+            }
+            batch.stats.writeJson(statsFile);
+        }
+        return 0;
+    }
+
+    if (shardGrid)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        shard::ShardRunConfig config;
+        config.grid = *shardGrid;
+        config.grid.halo = halo;
+        config.seed = seed;
+        config.roundLimit = maxRounds;
+        config.textEvents = textEvents;
+        config.worldHashEvents = worldHashEvents;
+        std::cout << "\n\nEvents:\n";
+        const auto result = shard::runShards(scenario, config, std::cout);
+        std::cerr << "Shards: " << config.grid.columns << 'x' << config.grid.rows << " (halo " << halo << ") in "
+                  << result.elapsed.count() << " ms, " << result.rounds << " rounds, " << result.survivors
+                  << " survivors, hash=" << result.finalHash << '\n';
+        return 0;
+#else
+        throw std::runtime_error("Error: --shards requires fork and shared memory");
+#endif
+    }
+
+    core::Engine engine;
+    if (seed)
+    {
+        engine.setSeed(*seed);
+    }
+    if (textEvents)
+    {
+        engine.getEventLog().setTextEvents(*textEvents);
+    }
+    engine.setWorldHashEvents(worldHashEvents);
+    engine.setStrictAllocations(strictAllocationsAfter);
+    // all events go to the archive, independently of the text output
+    std::ofstream archiveFile;
+    std::unique_ptr<archive::EventArchiveWriter> archiveWriter;
+    if (!archivePath.empty())
+    {
+        archiveFile.open(archivePath, std::ios::binary);
+        if (!archiveFile)
+        {
+            throw std::runtime_error("Error: Cannot create archive - " + archivePath);
+        }
+        archiveWriter = std::make_unique<archive::EventArchiveWriter>(archiveFile);
+        archiveWriter->attach(engine.getEventLog());
+    }
+    // trace is kept in memory for the whole run and written once at exit
+    std::unique_ptr<TraceWriter> tracer;
+    if (!tracePath.empty())
+    {
+        tracer = std::make_unique<TraceWriter>();
+        engine.setTraceWriter(tracer.get());
+    }
 
     std::cout << "\n\nEvents:\n";
 
     // Now execute deferred commands (they will emit events which should be printed under Events)
-    for (auto &fn : pendingCommands) {
-        fn();
+    scenario.applyTo(engine);
+    const uint32_t spawnedUnits = engine.getMap().getUnitsCount();
+
+    engine.setRoundLimit(maxRounds);
+    if (roundDelayMs)
+    {
+        engine.setRoundDelay(std::chrono::milliseconds(*roundDelayMs));
+    }
+    // live map view goes to stderr, stdout keeps the event log
+    std::unique_ptr<MapRenderer> renderer;
+    if (render)
+    {
+        const auto& map = engine.getMap();
+        renderer = std::make_unique<MapRenderer>(viewport.value_or(MapRenderer::fitToMap(map.getWidth(), map.getHeight())));
+        engine.setRenderer(renderer.get(), std::cerr);
+    }
+
+    // live world state for observer processes, sized for the units spawned by the scenario
+#if defined(__unix__) || defined(__APPLE__)
+    std::optional<observer::SharedSnapshot> snapshotSegment;
+    std::unique_ptr<snapshot::SnapshotWriter> snapshotWriter;
+    if (publishSnapshot)
+    {
+        const auto& map = engine.getMap();
+        const auto capacity = std::max<uint32_t>(spawnedUnits, 1);
+        snapshotSegment.emplace(observer::SharedSnapshot::create(
+            snapshotName.empty() ? observer::DEFAULT_SNAPSHOT_NAME : snapshotName, capacity));
+        snapshotWriter = std::make_unique<snapshot::SnapshotWriter>(snapshotSegment->data(), capacity, map.getWidth(), map.getHeight());
+        engine.setSnapshotWriter(snapshotWriter.get());
+    }
+#else
+    if (publishSnapshot)
+    {
+        throw std::runtime_error("Error: --snapshot requires POSIX shared memory");
+    }
+#endif
+
+    if (!profileReportPath.empty())
+    {
+#if SW_PROFILER
+        core::Profiler::getInstance().start();
+#else
+        std::cerr << "Profiler is not compiled in, configure with -DSW_ENABLE_PROFILER=ON\n";
+#endif
     }
 
     // Run simulation after commands applied
     engine.simulateRounds();
 
+    if (allocationReport)
+    {
+        // peak per unit is against the spawned units, most of them are gone by now
+        core::AllocationTracker::printReport(std::cerr, spawnedUnits);
+    }
+
+    if (archiveWriter)
+    {
+        archiveWriter->finish();
+        std::cerr << "Archive: " << engine.getEventLog().getEventsLogged() << " events, " << archiveWriter->getBytesWritten()
+                  << " bytes (columns " << archiveWriter->getRawBytes() << " bytes)\n";
+    }
+
+    if (tracer)
+    {
+        std::ofstream traceFile(tracePath);
+        tracer->writeJson(traceFile);
+    }
+
+#if SW_PROFILER
+    if (!profileReportPath.empty())
+    {
+        auto& profiler = core::Profiler::getInstance();
+        profiler.stop();
+        // summary goes to stderr to keep the event log on stdout intact
+        profiler.printSummary(std::cerr);
+        std::ofstream report(profileReportPath);
+        profiler.writeJson(report);
+    }
+#endif
+
     return 0;
 }
@@ -0,0 +1,77 @@
+//
+// Created by Carpov Pavel on 25.10.2025.
+//
+
+// Decodes an event archive written with sw_battle_test --archive back to the text event log.
+// usage: sw_battle_archive [--from=tick] [--to=tick] [--info] <archive file>
+
+#include <IO/Archive/EventArchive.hpp>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	using namespace sw;
+
+	std::string archivePath;
+	uint64_t fromTick = 0;
+	uint64_t toTick = std::numeric_limits<uint64_t>::max();
+	bool info = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg.rfind("--from=", 0) == 0)
+		{
+			fromTick = std::stoull(arg.substr(std::string("--from=").size()));
+		}
+		else if (arg.rfind("--to=", 0) == 0)
+		{
+			toTick = std::stoull(arg.substr(std::string("--to=").size()));
+		}
+		else if (arg == "--info")
+		{
+			info = true;
+		}
+		else if (arg.rfind("--", 0) == 0)
+		{
+			throw std::runtime_error("Error: Unknown option - " + arg);
+		}
+		else
+		{
+			archivePath = arg;
+		}
+	}
+	if (archivePath.empty())
+	{
+		throw std::runtime_error("Error: No file specified in command line argument");
+	}
+	std::ifstream file(archivePath, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Error: File not found - " + archivePath);
+	}
+
+	archive::EventArchiveReader reader(file);
+	if (info)
+	{
+		uint64_t events = 0;
+		uint64_t rawBytes = 0;
+		uint64_t compressedBytes = 0;
+		for (const auto& block : reader.getBlocks())
+		{
+			std::cout << "block ticks " << block.firstTick << ".." << block.lastTick << ", " << block.events
+					  << " events, " << block.rawSize << " -> " << block.compressedSize << " bytes\n";
+			events += block.events;
+			rawBytes += block.rawSize;
+			compressedBytes += block.compressedSize;
+		}
+		std::cout << reader.getBlocks().size() << " blocks, " << events << " events, columns " << rawBytes
+				  << " bytes, compressed " << compressedBytes << " bytes\n";
+		return 0;
+	}
+	reader.decodeText(std::cout, fromTick, toTick);
+	return 0;
+}
@@ -0,0 +1,676 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+// End-to-end performance regression harness: plays a fixed corpus of generated reference battles several times
+// each, every sample in a forked process of its own (clean peak RSS and allocation counters), and compares the
+// measurements with a stored baseline. Exit code 1 if a metric regressed significantly beyond the threshold,
+// 2 if a scenario no longer plays the same battle as in the baseline (the baseline is stale).
+// usage: sw_battle_bench [--list] [--scenarios=name,...] [--repeat=N] [--out=results.json]
+//                        [--baseline=baseline.json [--threshold=percent] [--alpha=p]]
+
+#include <Core/Engine/AllocationTracker.hpp>
+#include <Core/Engine/Engine.hpp>
+#include <Core/Engine/Scenario.hpp>
+#include <IO/Stats/SampleComparison.hpp>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	// a reference battle, generated from its seed: the same scenario on every machine and every build
+	struct ReferenceScenario
+	{
+		const char* name;
+		uint32_t units;
+		uint32_t mapSize; // square map
+		uint32_t roundLimit; // 0 plays the battle to its end
+		uint64_t seed;
+	};
+
+	constexpr std::array<ReferenceScenario, 5> CORPUS{{
+		{"skirmish", 16, 12, 0, 1},
+		{"battle-1k", 1'000, 200, 0, 2},
+		{"battle-10k", 10'000, 640, 300, 3},
+		{"battle-100k", 100'000, 2'000, 20, 4},
+		{"battle-1m", 1'000'000, 6'400, 4, 5},
+	}};
+
+	// splitmix64: the corpus must not depend on the standard library's distributions
+	struct CorpusRandom
+	{
+		uint64_t state;
+
+		uint64_t next()
+		{
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+		uint32_t below(uint32_t bound) { return static_cast<uint32_t>(next() % bound); }
+		uint32_t between(uint32_t low, uint32_t high) { return low + below(high - low + 1); }
+	};
+
+	// half swordsmen, then hunters, healers and mines on distinct cells; nine of ten mobile units march somewhere
+	std::string generateCommands(const ReferenceScenario& reference)
+	{
+		CorpusRandom random{reference.seed};
+		const uint32_t size = reference.mapSize;
+		std::ostringstream out;
+		out << "CREATE_MAP " << size << ' ' << size << '\n';
+		std::vector<bool> used(static_cast<size_t>(size) * size);
+		std::vector<uint32_t> marching;
+		for (uint32_t id = 1; id <= reference.units; ++id)
+		{
+			uint32_t x = 0;
+			uint32_t y = 0;
+			do
+			{
+				x = random.below(size);
+				y = random.below(size);
+			}
+			while (used[static_cast<size_t>(y) * size + x]);
+			used[static_cast<size_t>(y) * size + x] = true;
+
+			const uint32_t kind = random.below(10);
+			if (kind < 5)
+			{
+				out << "SPAWN_SWORDSMAN " << id << ' ' << x << ' ' << y << ' ' << random.between(5, 20) << ' '
+					<< random.between(1, 5) << '\n';
+			}
+			else if (kind < 8)
+			{
+				out << "SPAWN_HUNTER " << id << ' ' << x << ' ' << y << ' ' << random.between(5, 15) << ' '
+					<< random.between(1, 5) << ' ' << random.between(1, 3) << ' ' << random.between(2, 5) << '\n';
+			}
+			else if (kind < 9)
+			{
+				out << "SPAWN_HEALER " << id << ' ' << x << ' ' << y << ' ' << random.between(5, 15) << ' '
+					<< random.between(1, 3) << " 2\n";
+			}
+			else
+			{
+				out << "SPAWN_MINE " << id << ' ' << x << ' ' << y << ' ' << random.between(3, 8) << " 2 3\n";
+				continue;
+			}
+			if (random.below(10) != 0)
+			{
+				marching.push_back(id);
+			}
+		}
+		for (const uint32_t id : marching)
+		{
+			out << "MARCH " << id << ' ' << random.below(size) << ' ' << random.below(size) << '\n';
+		}
+		return out.str();
+	}
+
+	// the text event output is formatted as in a real run, then dropped
+	class NullBuffer : public std::streambuf
+	{
+	protected:
+		int overflow(int c) override { return c; }
+		std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+	};
+
+	// what one run reports back to the harness through a pipe
+	struct RunSample
+	{
+		double wallMs{0};
+		uint64_t rounds{0};
+		uint64_t events{0};
+		uint64_t peakRssKb{0};
+		uint64_t allocations{0};
+		uint64_t finalHash{0};
+	};
+
+	// measured metrics, samples of each are compared with the baseline ones
+	struct Metric
+	{
+		const char* name;
+		bool higherIsBetter;
+	};
+	constexpr std::array<Metric, 5> METRICS{{
+		{"wallMs", false},
+		{"roundsPerSec", true},
+		{"eventsPerSec", true},
+		{"peakRssKb", false},
+		{"allocations", false},
+	}};
+
+	double metricOf(const RunSample& sample, size_t metric)
+	{
+		const double seconds = std::max(sample.wallMs, 1e-3) / 1000.0;
+		switch (metric)
+		{
+			case 0: return sample.wallMs;
+			case 1: return static_cast<double>(sample.rounds) / seconds;
+			case 2: return static_cast<double>(sample.events) / seconds;
+			case 3: return static_cast<double>(sample.peakRssKb);
+			default: return static_cast<double>(sample.allocations);
+		}
+	}
+
+	// measurements of one scenario: the battle outcome identifies it, the metrics have one value per sample
+	struct ScenarioResult
+	{
+		std::string name;
+		uint64_t rounds{0};
+		uint64_t events{0};
+		uint64_t finalHash{0};
+		std::array<std::vector<double>, METRICS.size()> samples;
+	};
+
+	RunSample playSample(const sw::core::Scenario& scenario, const ReferenceScenario& reference)
+	{
+		NullBuffer discard;
+		std::ostream events(&discard);
+		const uint64_t allocationsBefore = sw::core::AllocationTracker::counters().totalAllocations();
+		const auto started = std::chrono::steady_clock::now();
+		sw::core::Engine engine(events);
+		engine.setSeed(reference.seed);
+		engine.setRoundDelay(std::chrono::milliseconds(0));
+		engine.setRoundLimit(reference.roundLimit);
+		scenario.applyTo(engine);
+		engine.simulateRounds();
+		RunSample sample;
+		sample.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+		sample.rounds = engine.getRound();
+		sample.events = engine.getEventLog().getEventsLogged();
+		sample.allocations = sw::core::AllocationTracker::counters().totalAllocations() - allocationsBefore;
+		sample.finalHash = engine.getFinalHash();
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		sample.peakRssKb = static_cast<uint64_t>(usage.ru_maxrss); // kilobytes on Linux
+		return sample;
+	}
+
+	// plays one sample in a child process, so its peak RSS and allocations are its own
+	RunSample forkSample(const sw::core::Scenario& scenario, const ReferenceScenario& reference)
+	{
+		int fds[2];
+		if (pipe(fds) != 0)
+		{
+			throw std::runtime_error("Error: pipe failed");
+		}
+		std::cout.flush();
+		const pid_t child = fork();
+		if (child < 0)
+		{
+			throw std::runtime_error("Error: fork failed");
+		}
+		if (child == 0)
+		{
+			close(fds[0]);
+			int status = 1;
+			try
+			{
+				const RunSample sample = playSample(scenario, reference);
+				status = write(fds[1], &sample, sizeof(sample)) == static_cast<ssize_t>(sizeof(sample)) ? 0 : 1;
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << reference.name << ": " << e.what() << '\n';
+			}
+			_exit(status);
+		}
+		close(fds[1]);
+		RunSample sample;
+		size_t received = 0;
+		while (received < sizeof(sample))
+		{
+			const ssize_t n = read(fds[0], reinterpret_cast<char*>(&sample) + received, sizeof(sample) - received);
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n <= 0)
+			{
+				break;
+			}
+			received += static_cast<size_t>(n);
+		}
+		close(fds[0]);
+		int status = 0;
+		waitpid(child, &status, 0);
+		if (received != sizeof(sample) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			throw std::runtime_error(std::string("Error: run of ") + reference.name + " failed");
+		}
+		return sample;
+	}
+
+	ScenarioResult measure(const ReferenceScenario& reference, uint32_t repeat)
+	{
+		std::istringstream commands(generateCommands(reference));
+		const auto scenario = sw::core::Scenario::parse(commands);
+		ScenarioResult result;
+		result.name = reference.name;
+		for (uint32_t i = 0; i < repeat; ++i)
+		{
+			const RunSample sample = forkSample(scenario, reference);
+			if (i > 0 && (sample.rounds != result.rounds || sample.finalHash != result.finalHash))
+			{
+				throw std::runtime_error(std::string("Error: ") + reference.name + " is not deterministic");
+			}
+			result.rounds = sample.rounds;
+			result.events = sample.events;
+			result.finalHash = sample.finalHash;
+			for (size_t m = 0; m < METRICS.size(); ++m)
+			{
+				result.samples[m].push_back(metricOf(sample, m));
+			}
+		}
+		return result;
+	}
+
+	void writeResults(std::ostream& stream, const std::vector<ScenarioResult>& results)
+	{
+		stream << "{\n  \"scenarios\": [";
+		bool first = true;
+		for (const auto& result : results)
+		{
+			stream << (first ? "\n" : ",\n");
+			first = false;
+			stream << "    {\"name\": \"" << result.name << "\", \"rounds\": " << result.rounds << ", \"events\": "
+				   << result.events << ", \"finalHash\": \"" << result.finalHash << "\",\n     \"samples\": {";
+			for (size_t m = 0; m < METRICS.size(); ++m)
+			{
+				stream << (m ? ", " : "") << '"' << METRICS[m].name << "\": [";
+				for (size_t i = 0; i < result.samples[m].size(); ++i)
+				{
+					stream << (i ? ", " : "") << std::setprecision(17) << result.samples[m][i];
+				}
+				stream << ']';
+			}
+			stream << "}}";
+		}
+		stream << "\n  ]\n}\n";
+	}
+
+	// Reader of the files written by writeResults: objects, arrays, strings without escapes and numbers
+	class BaselineReader
+	{
+		const std::string& text;
+		size_t at{0};
+
+		void skipSpaces()
+		{
+			while (at < text.size() && std::isspace(static_cast<unsigned char>(text[at])))
+			{
+				++at;
+			}
+		}
+		void expect(char c)
+		{
+			skipSpaces();
+			if (at >= text.size() || text[at] != c)
+			{
+				throw std::runtime_error(std::string("Error: Bad baseline, expected '") + c + "' at offset " + std::to_string(at));
+			}
+			++at;
+		}
+		bool accept(char c)
+		{
+			skipSpaces();
+			if (at < text.size() && text[at] == c)
+			{
+				++at;
+				return true;
+			}
+			return false;
+		}
+		std::string readString()
+		{
+			expect('"');
+			const size_t end = text.find('"', at);
+			if (end == std::string::npos)
+			{
+				throw std::runtime_error("Error: Bad baseline, unterminated string");
+			}
+			std::string value = text.substr(at, end - at);
+			at = end + 1;
+			return value;
+		}
+		double readNumber()
+		{
+			skipSpaces();
+			const char* begin = text.c_str() + at;
+			char* end = nullptr;
+			const double value = std::strtod(begin, &end);
+			if (end == begin)
+			{
+				throw std::runtime_error("Error: Bad baseline, expected a number at offset " + std::to_string(at));
+			}
+			at += static_cast<size_t>(end - begin);
+			return value;
+		}
+		// calls fn(key) for every member, fn reads the value
+		template <typename TFunc>
+		void readObject(TFunc&& fn)
+		{
+			expect('{');
+			if (accept('}'))
+			{
+				return;
+			}
+			do
+			{
+				const std::string key = readString();
+				expect(':');
+				fn(key);
+			}
+			while (accept(','));
+			expect('}');
+		}
+		template <typename TFunc>
+		void readArray(TFunc&& fn)
+		{
+			expect('[');
+			if (accept(']'))
+			{
+				return;
+			}
+			do
+			{
+				fn();
+			}
+			while (accept(','));
+			expect(']');
+		}
+
+	public:
+		explicit BaselineReader(const std::string& text_) : text(text_) {}
+
+		std::vector<ScenarioResult> read()
+		{
+			std::vector<ScenarioResult> results;
+			readObject([&](const std::string& key)
+			{
+				if (key != "scenarios")
+				{
+					throw std::runtime_error("Error: Bad baseline, unknown key " + key);
+				}
+				readArray([&] { results.push_back(readScenario()); });
+			});
+			return results;
+		}
+
+	private:
+		ScenarioResult readScenario()
+		{
+			ScenarioResult result;
+			readObject([&](const std::string& key)
+			{
+				if (key == "name")
+				{
+					result.name = readString();
+				}
+				else if (key == "rounds")
+				{
+					result.rounds = static_cast<uint64_t>(readNumber());
+				}
+				else if (key == "events")
+				{
+					result.events = static_cast<uint64_t>(readNumber());
+				}
+				else if (key == "finalHash")
+				{
+					result.finalHash = std::stoull(readString());
+				}
+				else if (key == "samples")
+				{
+					readObject([&](const std::string& metric)
+					{
+						const auto it = std::find_if(METRICS.begin(), METRICS.end(),
+							[&metric](const Metric& m) { return metric == m.name; });
+						std::vector<double> values;
+						readArray([&] { values.push_back(readNumber()); });
+						// metrics added after the baseline was recorded are skipped
+						if (it != METRICS.end())
+						{
+							result.samples[static_cast<size_t>(it - METRICS.begin())] = std::move(values);
+						}
+					});
+				}
+				else
+				{
+					throw std::runtime_error("Error: Bad baseline, unknown scenario key " + key);
+				}
+			});
+			return result;
+		}
+	};
+
+	std::vector<ScenarioResult> loadBaseline(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			throw std::runtime_error("Error: File not found - " + path);
+		}
+		std::stringstream text;
+		text << file.rdbuf();
+		return BaselineReader(text.str()).read();
+	}
+
+	enum class Verdict
+	{
+		Same,
+		Improved,
+		Regressed
+	};
+
+	// Compares every metric with its baseline samples. A metric regresses when it got worse by more than the
+	// threshold (relative to the baseline mean) and Welch's test says the difference is not noise (p < alpha).
+	// Returns 0, 1 on a regression or 2 when the battle itself differs from the baseline one.
+	int compare(const std::vector<ScenarioResult>& baseline, const std::vector<ScenarioResult>& results, double threshold, double alpha)
+	{
+		int status = 0;
+		std::cout << std::left << std::setw(14) << "scenario" << std::setw(14) << "metric" << std::right << std::setw(16)
+				  << "baseline" << std::setw(16) << "current" << std::setw(10) << "change" << std::setw(10) << "p" << "  verdict\n";
+		for (const auto& result : results)
+		{
+			const auto base = std::find_if(baseline.begin(), baseline.end(),
+				[&result](const ScenarioResult& b) { return b.name == result.name; });
+			if (base == baseline.end())
+			{
+				std::cout << std::left << std::setw(14) << result.name << "not in the baseline\n";
+				continue;
+			}
+			if (base->rounds != result.rounds || base->events != result.events || base->finalHash != result.finalHash)
+			{
+				std::cout << std::left << std::setw(14) << result.name << "plays a different battle than the baseline ("
+						  << base->rounds << " -> " << result.rounds << " rounds, " << base->events << " -> " << result.events
+						  << " events): record a new baseline\n";
+				status = std::max(status, 2);
+				continue;
+			}
+			for (size_t m = 0; m < METRICS.size(); ++m)
+			{
+				if (base->samples[m].empty())
+				{
+					continue;
+				}
+				const auto before = sw::stats::summarize(base->samples[m]);
+				const auto after = sw::stats::summarize(result.samples[m]);
+				const auto test = sw::stats::welchTest(base->samples[m], result.samples[m]);
+				const double change = before.mean != 0 ? (after.mean - before.mean) / before.mean : (after.mean != 0 ? 1.0 : 0.0);
+				const double worse = METRICS[m].higherIsBetter ? -change : change;
+				Verdict verdict = Verdict::Same;
+				if (test.pValue < alpha && std::fabs(change) > threshold)
+				{
+					verdict = worse > 0 ? Verdict::Regressed : Verdict::Improved;
+				}
+				if (verdict == Verdict::Regressed)
+				{
+					status = std::max(status, 1);
+				}
+				std::ostringstream changeText;
+				changeText << std::showpos << std::fixed << std::setprecision(1) << change * 100 << '%';
+				std::cout << std::left << std::setw(14) << result.name << std::setw(14) << METRICS[m].name << std::right
+						  << std::fixed << std::setprecision(before.mean < 100 ? 2 : 1) << std::setw(16) << before.mean
+						  << std::setw(16) << after.mean << std::setw(10) << changeText.str() << std::setprecision(3) << std::setw(10) << test.pValue << "  "
+						  << (verdict == Verdict::Regressed ? "REGRESSED" : verdict == Verdict::Improved ? "improved" : "same")
+						  << '\n';
+			}
+		}
+		return status;
+	}
+
+	void printResults(const std::vector<ScenarioResult>& results)
+	{
+		std::cout << std::left << std::setw(14) << "scenario" << std::right << std::setw(10) << "rounds" << std::setw(12)
+				  << "events";
+		for (const auto& metric : METRICS)
+		{
+			std::cout << std::setw(16) << metric.name;
+		}
+		std::cout << '\n';
+		for (const auto& result : results)
+		{
+			std::cout << std::left << std::setw(14) << result.name << std::right << std::setw(10) << result.rounds
+					  << std::setw(12) << result.events << std::fixed << std::setprecision(1);
+			for (const auto& samples : result.samples)
+			{
+				const auto summary = sw::stats::summarize(samples);
+				std::ostringstream cell;
+				cell << std::fixed << std::setprecision(summary.mean < 100 ? 2 : 0) << summary.mean << "±"
+					 << std::setprecision(summary.mean < 100 ? 2 : 0) << summary.stddev;
+				std::cout << std::setw(17) << cell.str(); // "±" is two bytes
+			}
+			std::cout << '\n';
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t repeat = 5;
+	std::vector<std::string> selected;
+	std::string outPath;
+	std::string baselinePath;
+	double threshold = 0.05;
+	double alpha = 0.05;
+	bool list = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--list")
+		{
+			list = true;
+		}
+		else if (arg.rfind("--scenarios=", 0) == 0)
+		{
+			std::istringstream names(arg.substr(std::string("--scenarios=").size()));
+			std::string name;
+			while (std::getline(names, name, ','))
+			{
+				selected.push_back(name);
+			}
+		}
+		else if (arg.rfind("--repeat=", 0) == 0)
+		{
+			repeat = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--repeat=").size())));
+		}
+		else if (arg.rfind("--out=", 0) == 0)
+		{
+			outPath = arg.substr(std::string("--out=").size());
+		}
+		else if (arg.rfind("--baseline=", 0) == 0)
+		{
+			baselinePath = arg.substr(std::string("--baseline=").size());
+		}
+		else if (arg.rfind("--threshold=", 0) == 0)
+		{
+			threshold = std::stod(arg.substr(std::string("--threshold=").size())) / 100.0;
+		}
+		else if (arg.rfind("--alpha=", 0) == 0)
+		{
+			alpha = std::stod(arg.substr(std::string("--alpha=").size()));
+		}
+		else
+		{
+			throw std::runtime_error("Error: Unknown option - " + arg);
+		}
+	}
+	if (list)
+	{
+		for (const auto& reference : CORPUS)
+		{
+			std::cout << reference.name << ": " << reference.units << " units on " << reference.mapSize << 'x'
+					  << reference.mapSize << ", seed " << reference.seed << ", "
+					  << (reference.roundLimit ? std::to_string(reference.roundLimit) + " rounds" : std::string("to the end"))
+					  << '\n';
+		}
+		return 0;
+	}
+	if (repeat == 0)
+	{
+		throw std::runtime_error("Error: --repeat must be at least 1");
+	}
+	for (const auto& name : selected)
+	{
+		if (std::none_of(CORPUS.begin(), CORPUS.end(), [&name](const ReferenceScenario& r) { return name == r.name; }))
+		{
+			throw std::runtime_error("Error: Unknown scenario - " + name);
+		}
+	}
+	if (!sw::core::AllocationTracker::hooksInstalled())
+	{
+		std::cerr << "allocation hooks are not linked in, allocations are reported as 0\n";
+	}
+	// read before the runs: a bad baseline path should not cost a whole corpus run
+	std::optional<std::vector<ScenarioResult>> baseline;
+	if (!baselinePath.empty())
+	{
+		baseline = loadBaseline(baselinePath);
+	}
+
+	std::vector<ScenarioResult> results;
+	for (const auto& reference : CORPUS)
+	{
+		if (!selected.empty() && std::find(selected.begin(), selected.end(), reference.name) == selected.end())
+		{
+			continue;
+		}
+		std::cerr << reference.name << ": " << repeat << " runs\n";
+		results.push_back(measure(reference, repeat));
+	}
+	printResults(results);
+	if (!outPath.empty())
+	{
+		std::ofstream out(outPath);
+		if (!out)
+		{
+			throw std::runtime_error("Error: Cannot write " + outPath);
+		}
+		writeResults(out, results);
+	}
+	if (!baseline)
+	{
+		return 0;
+	}
+	std::cout << '\n';
+	return compare(*baseline, results, threshold, alpha);
+}
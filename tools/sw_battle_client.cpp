@@ -0,0 +1,173 @@
+//
+// Created by Carpov Pavel on 23.10.2025.
+//
+
+// Minimal client of the simulation server: sends a scenario, prints the event log to stdout and
+// the request stats to stderr.
+// usage: sw_battle_client [--socket=path] [--binary [--units=definitions file]] <commands file>
+//        sw_battle_client [--socket=path] --status
+
+#include "IO/Commands/CreateMap.hpp"
+#include "IO/Commands/March.hpp"
+#include "IO/Commands/SpawnHealer.hpp"
+#include "IO/Commands/SpawnHunter.hpp"
+#include "IO/Commands/SpawnMine.hpp"
+#include "IO/Commands/SpawnSwordsman.hpp"
+
+#include <Core/Units/UnitDefinitions.hpp>
+#include <IO/System/CommandParser.hpp>
+#include <IO/System/details/BinaryCommandVisitors.hpp>
+#include <Server/Protocol.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/un.h>
+
+namespace
+{
+	using namespace sw;
+
+	// the server must be started with the same unit definitions
+	template <class... TCommands>
+	std::string toBinaryScenario(std::istream& text, const core::UnitDefinitions& units)
+	{
+		std::ostringstream out(std::ios::out | std::ios::binary);
+		io::CommandParser parser;
+		(parser.add<TCommands>([&out](TCommands command) { BinaryCommandWriterVisitor::write(out, command); }), ...);
+		for (const auto& definition : units.getAll())
+		{
+			parser.add<io::SpawnUnit>(definition.makeSpawnPrototype(),
+				[&out](io::SpawnUnit command) { BinaryCommandWriterVisitor::write(out, command); });
+		}
+		parser.parse(text);
+		return out.str();
+	}
+
+	int connectTo(const std::string& path)
+	{
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path))
+		{
+			throw std::runtime_error("Socket path is too long: " + path);
+		}
+		std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+		int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+		{
+			throw std::runtime_error("Cannot connect to " + path + ": " + std::strerror(errno));
+		}
+		return fd;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string socketPath = server::DEFAULT_SOCKET_PATH;
+	std::string scenarioPath;
+	bool binary = false;
+	bool status = false;
+	core::UnitDefinitions units;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg.rfind("--socket=", 0) == 0)
+		{
+			socketPath = arg.substr(std::string("--socket=").size());
+		}
+		else if (arg == "--binary")
+		{
+			binary = true;
+		}
+		else if (arg.rfind("--units=", 0) == 0)
+		{
+			units = core::UnitDefinitions::loadFile(arg.substr(std::string("--units=").size()));
+		}
+		else if (arg == "--status")
+		{
+			status = true;
+		}
+		else if (arg.rfind("--", 0) == 0)
+		{
+			throw std::runtime_error("Error: Unknown option - " + arg);
+		}
+		else
+		{
+			scenarioPath = arg;
+		}
+	}
+
+	server::FrameType requestType = server::FrameType::StatusQuery;
+	std::string request;
+	if (!status)
+	{
+		if (scenarioPath.empty())
+		{
+			throw std::runtime_error("Error: No file specified in command line argument");
+		}
+		std::ifstream file(scenarioPath);
+		if (!file)
+		{
+			throw std::runtime_error("Error: File not found - " + scenarioPath);
+		}
+		if (binary)
+		{
+			requestType = server::FrameType::BinaryScenario;
+			request = toBinaryScenario<io::CreateMap, io::SpawnSwordsman, io::SpawnHunter, io::SpawnMine,
+				io::SpawnHealer, io::March>(file, units);
+		}
+		else
+		{
+			requestType = server::FrameType::TextScenario;
+			request.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+	}
+
+	const int fd = connectTo(socketPath);
+	if (!server::writeFrame(fd, requestType, request))
+	{
+		throw std::runtime_error("Error: Failed to send the request");
+	}
+
+	server::FrameType type;
+	std::string payload;
+	while (server::readFrame(fd, type, payload))
+	{
+		switch (type)
+		{
+			case server::FrameType::EventChunk:
+				std::cout.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+				break;
+			case server::FrameType::Done:
+			{
+				const auto stats = server::decodeRequestStats(payload);
+				std::cout.flush();
+				std::cerr << "rounds " << stats.rounds << ", events " << stats.events << ", bytes " << stats.bytes
+						  << ", queue depth " << stats.queueDepth << ", wait " << stats.queueWaitNs / 1000
+						  << " us, run " << stats.runNs / 1000 << " us, total " << stats.totalNs / 1000 << " us\n";
+				::close(fd);
+				return 0;
+			}
+			case server::FrameType::Status:
+			{
+				const auto s = server::decodeServerStatus(payload);
+				std::cout << "workers " << s.workers << ", busy " << s.busyWorkers << ", queued " << s.queueDepth
+						  << ", completed " << s.completed << ", failed " << s.failed << '\n';
+				::close(fd);
+				return 0;
+			}
+			case server::FrameType::Error:
+				std::cout.flush();
+				std::cerr << "Error: " << payload << '\n';
+				::close(fd);
+				return 1;
+			default:
+				break;
+		}
+	}
+	::close(fd);
+	std::cerr << "Error: Connection closed before the request completed\n";
+	return 1;
+}
@@ -0,0 +1,94 @@
+//
+// Created by Carpov Pavel on 27.10.2025.
+//
+
+// Live observer of a running battle (sw_battle_test --snapshot): maps the snapshot segment read-only and prints
+// one summary line per new frame until the battle ends. Never touches the simulation process.
+// usage: sw_battle_observer [--name=shm name] [--interval=ms] [--once]
+
+#include <Observer/SharedSnapshot.hpp>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+	using namespace sw;
+
+	void printFrame(const snapshot::SnapshotFrame& frame)
+	{
+		uint32_t alive = 0;
+		uint64_t hp = 0;
+		std::map<uint32_t, uint32_t> aliveByTeam;
+		for (const auto& unit : frame.units)
+		{
+			if (unit.flags & snapshot::SNAPSHOT_UNIT_ALIVE)
+			{
+				++alive;
+				hp += unit.hp;
+				++aliveByTeam[unit.team];
+			}
+		}
+		std::cout << "frame=" << frame.number << " tick=" << frame.tick << " units=" << frame.units.size()
+				  << " alive=" << alive << " hp=" << hp;
+		if (aliveByTeam.size() > 1)
+		{
+			for (const auto& [team, count] : aliveByTeam)
+			{
+				std::cout << " team" << team << '=' << count;
+			}
+		}
+		std::cout << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string name = observer::DEFAULT_SNAPSHOT_NAME;
+	std::chrono::milliseconds interval{20};
+	bool once = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg.rfind("--name=", 0) == 0)
+		{
+			name = arg.substr(std::string("--name=").size());
+		}
+		else if (arg.rfind("--interval=", 0) == 0)
+		{
+			interval = std::chrono::milliseconds(std::stoul(arg.substr(std::string("--interval=").size())));
+		}
+		else if (arg == "--once")
+		{
+			once = true;
+		}
+		else
+		{
+			throw std::runtime_error("Error: Unknown option - " + arg);
+		}
+	}
+
+	const auto segment = observer::SharedSnapshot::open(name);
+	const auto& header = segment.header();
+	std::cout << "map=" << header.width << 'x' << header.height << " capacity=" << header.capacity << std::endl;
+	snapshot::SnapshotFrame frame;
+	uint64_t shown = 0;
+	while (true)
+	{
+		// read the flag first: a frame read after it is set is the last one
+		const bool finished = header.finished.load(std::memory_order_acquire) != 0;
+		if (snapshot::readLatest(header, frame) && frame.number != shown)
+		{
+			shown = frame.number;
+			printFrame(frame);
+		}
+		if (once || finished)
+		{
+			return 0;
+		}
+		std::this_thread::sleep_for(interval);
+	}
+}
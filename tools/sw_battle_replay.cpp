@@ -0,0 +1,137 @@
+//
+// Created by Carpov Pavel on 25.10.2025.
+//
+
+// Random access over a recorded battle (text event log or --archive file), without rerunning the simulation.
+// usage: sw_battle_replay [--at=tick [--render[=x,y,w,h[,zoom]]]] [--unit=id] <log file>
+
+#include <IO/Replay/ReplayIndex.hpp>
+#include <IO/System/MapRenderer.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	double millisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace sw;
+
+	std::string logPath;
+	std::optional<uint64_t> atTick;
+	std::optional<uint32_t> unitId;
+	bool render = false;
+	std::optional<Viewport> viewport;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg.rfind("--at=", 0) == 0)
+		{
+			atTick = std::stoull(arg.substr(std::string("--at=").size()));
+		}
+		else if (arg.rfind("--unit=", 0) == 0)
+		{
+			unitId = static_cast<uint32_t>(std::stoul(arg.substr(std::string("--unit=").size())));
+		}
+		else if (arg == "--render")
+		{
+			render = true;
+		}
+		else if (arg.rfind("--render=", 0) == 0)
+		{
+			Viewport v;
+			char comma;
+			std::istringstream spec(arg.substr(std::string("--render=").size()));
+			if (!(spec >> v.x >> comma >> v.y >> comma >> v.width >> comma >> v.height))
+			{
+				throw std::runtime_error("Error: Bad viewport, expected --render=x,y,width,height[,zoom] - " + arg);
+			}
+			if (spec >> comma)
+			{
+				spec >> v.zoom;
+			}
+			render = true;
+			viewport = v;
+		}
+		else if (arg.rfind("--", 0) == 0)
+		{
+			throw std::runtime_error("Error: Unknown option - " + arg);
+		}
+		else
+		{
+			logPath = arg;
+		}
+	}
+	if (logPath.empty())
+	{
+		throw std::runtime_error("Error: No file specified in command line argument");
+	}
+	std::ifstream file(logPath, std::ios::binary);
+	if (!file)
+	{
+		throw std::runtime_error("Error: File not found - " + logPath);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	replay::ReplayIndex index(file);
+	std::cerr << "Loaded " << index.getEventsCount() << " events, ticks " << index.getFirstTick() << ".."
+			  << index.getLastTick() << ", " << index.getUnitsCount() << " units, " << index.getKeyframesCount()
+			  << " keyframes in " << millisecondsSince(start) << " ms\n";
+
+	if (unitId)
+	{
+		for (const auto& record : index.historyOf(*unitId))
+		{
+			index.describe(std::cout, record);
+		}
+	}
+
+	if (atTick)
+	{
+		start = std::chrono::steady_clock::now();
+		const replay::WorldState state = index.stateAt(*atTick);
+		std::cerr << "State at tick " << *atTick << " rebuilt in " << millisecondsSince(start) << " ms\n";
+		if (render)
+		{
+			MapRenderer renderer(viewport.value_or(MapRenderer::fitToMap(state.width, state.height)));
+			renderer.clear();
+			for (const auto& [id, unit] : state.units)
+			{
+				const std::string& type = index.getUnitType(unit.typeIndex);
+				// the log does not record solidity, mines are the only non-solid units
+				renderer.plot(unit.x, unit.y, type, type != "Mine");
+			}
+			renderer.present(std::cout);
+		}
+		else
+		{
+			std::cout << "Tick " << *atTick << ", map " << state.width << "x" << state.height << ", "
+					  << state.units.size() << " units\n";
+			for (const auto& [id, unit] : state.units)
+			{
+				std::cout << "unit " << id << " " << index.getUnitType(unit.typeIndex) << " at " << unit.x << ","
+						  << unit.y << " hp ";
+				if (unit.hp)
+				{
+					std::cout << *unit.hp;
+				}
+				else
+				{
+					std::cout << "?";
+				}
+				std::cout << '\n';
+			}
+		}
+	}
+	return 0;
+}